@@ -0,0 +1,164 @@
+#include <benchmark/benchmark.h>
+
+#include "bench/bench.h"
+#include "board/board.h"
+#include "board/transposition.h"
+#include "eval/batch.h"
+#include "eval/simd.h"
+#include "generator/generator.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+#include <random>
+#include <vector>
+
+// Each benchmark runs its primitive over every position of the bench suite per iteration. items_per_second is
+// primitive calls per second; time_per_op is its inverse.
+namespace {
+
+std::vector<Board>& corpus() {
+    static std::vector<Board> boards = [] {
+        Zobrist::init();
+        std::vector<Board> result;
+        for (const std::string& fen : Bench::positions()) result.emplace_back(fen);
+        return result;
+    }();
+    return boards;
+}
+
+void report(benchmark::State& state, const int64_t opsPerIteration) {
+    state.SetItemsProcessed(state.iterations() * opsPerIteration);
+    state.counters["time_per_op"] = benchmark::Counter(static_cast<double>(opsPerIteration),
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+void BM_MakeUndoMove(benchmark::State& state) {
+    std::vector<Board>& boards = corpus();
+    std::vector<std::vector<Move>> moves;
+    int64_t ops = 0;
+    for (Board& board : boards) {
+        moves.push_back(Generator::generatePseudoMoves(board));
+        ops += static_cast<int64_t>(moves.back().size());
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < boards.size(); i++) {
+            for (const Move& move : moves[i]) {
+                MoveUndo undo = boards[i].makeMove(move, false);
+                boards[i].undoMove(undo);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    report(state, ops);
+}
+BENCHMARK(BM_MakeUndoMove);
+
+void BM_GeneratePseudoMoves(benchmark::State& state) {
+    std::vector<Board>& boards = corpus();
+    for (auto _ : state) {
+        for (Board& board : boards) benchmark::DoNotOptimize(Generator::generatePseudoMoves(board));
+    }
+    report(state, static_cast<int64_t>(boards.size()));
+}
+BENCHMARK(BM_GeneratePseudoMoves);
+
+void BM_GenerateCaptures(benchmark::State& state) {
+    std::vector<Board>& boards = corpus();
+    for (auto _ : state) {
+        for (const Board& board : boards) benchmark::DoNotOptimize(Generator::generateCaptures(board));
+    }
+    report(state, static_cast<int64_t>(boards.size()));
+}
+BENCHMARK(BM_GenerateCaptures);
+
+void BM_IsChecked(benchmark::State& state) {
+    std::vector<Board>& boards = corpus();
+    for (auto _ : state) {
+        for (const Board& board : boards) benchmark::DoNotOptimize(board.isChecked(board.getColor()));
+    }
+    report(state, static_cast<int64_t>(boards.size()));
+}
+BENCHMARK(BM_IsChecked);
+
+void BM_SquareAttacked(benchmark::State& state) {
+    std::vector<Board>& boards = corpus();
+    for (auto _ : state) {
+        for (const Board& board : boards) {
+            const Color enemy = board.getColor() == Color::White ? Color::Black : Color::White;
+            for (int r = 0; r < 8; r++) {
+                for (int c = 0; c < 8; c++) benchmark::DoNotOptimize(board.squareAttacked(Square(r, c), enemy));
+            }
+        }
+    }
+    report(state, static_cast<int64_t>(boards.size()) * 64);
+}
+BENCHMARK(BM_SquareAttacked);
+
+void BM_Evaluate(benchmark::State& state) {
+    std::vector<Board>& boards = corpus();
+    for (auto _ : state) {
+        for (const Board& board : boards) benchmark::DoNotOptimize(Search::evaluate(board));
+    }
+    report(state, static_cast<int64_t>(boards.size()));
+}
+BENCHMARK(BM_Evaluate);
+
+// The bench suite repeated to 64k positions in a batch; the argument is the thread count
+void BM_EvaluateBatch(benchmark::State& state) {
+    PositionBatch batch;
+    while (batch.size() < (1 << 16)) {
+        for (const Board& board : corpus()) batch.add(board);
+    }
+    std::vector<int> scores(batch.size());
+    for (auto _ : state) {
+        BatchEvaluator::evaluate(batch, scores, static_cast<int>(state.range(0)));
+        benchmark::ClobberMemory();
+    }
+    report(state, static_cast<int64_t>(batch.size()));
+}
+BENCHMARK(BM_EvaluateBatch)->Arg(1)->Arg(4)->UseRealTime();
+
+// The mobility kernel over a full set of 32 pieces; the argument is the Simd::Level
+void BM_WeightedPopcount(benchmark::State& state) {
+    const auto level = static_cast<Simd::Level>(state.range(0));
+    if (level > Simd::detect()) {
+        state.SkipWithError("not supported on this CPU");
+        return;
+    }
+    std::mt19937_64 rng(12345);
+    uint64_t bits[32];
+    int16_t weights[32];
+    for (int i = 0; i < 32; i++) {
+        bits[i] = rng() & rng();
+        weights[i] = static_cast<int16_t>(i % 7 - 3);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        benchmark::DoNotOptimize(Simd::weightedPopcount(level, bits, weights, 32));
+    }
+    state.SetLabel(Simd::name(level));
+    report(state, 1);
+}
+BENCHMARK(BM_WeightedPopcount)->DenseRange(0, 2);
+
+// Half the probes hit stored keys, half miss, in an order the prefetcher can't follow
+void BM_TTProbe(benchmark::State& state) {
+    TranspositionTable tt(16);
+    std::mt19937_64 rng(12345);
+    std::vector<uint64_t> keys(1 << 16);
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = rng();
+        if (i % 2 == 0) tt.store(keys[i], 0, 1, EXACT, Move());
+    }
+
+    for (auto _ : state) {
+        for (const uint64_t key : keys) benchmark::DoNotOptimize(tt.probe(key));
+    }
+    report(state, static_cast<int64_t>(keys.size()));
+}
+BENCHMARK(BM_TTProbe);
+
+}
+
+BENCHMARK_MAIN();
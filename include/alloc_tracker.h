@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct AllocCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+
+    AllocCounts& operator+=(const AllocCounts& other) {
+        allocations += other.allocations;
+        bytes += other.bytes;
+        return *this;
+    }
+    AllocCounts operator-(const AllocCounts& other) const {
+        return {allocations - other.allocations, bytes - other.bytes};
+    }
+};
+
+// Counts heap allocations per thread. Configure with -DCHESS_ALLOC_TRACKING=ON to link the replacement global
+// operator new (src/alloc/alloc_hooks.cpp) into the executables; otherwise nothing is recorded and counts()
+// stays zero. Take a snapshot before and after a region and subtract to attribute allocations to it.
+class AllocTracker {
+public:
+#ifdef CHESS_ALLOC_TRACKING
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    // Constant-initialized, so it is safe to touch from inside operator new before anything else has run
+    static AllocCounts& counts() {
+        thread_local AllocCounts local;
+        return local;
+    }
+
+    static void record(const size_t bytes) {
+        AllocCounts& local = counts();
+        local.allocations++;
+        local.bytes += bytes;
+    }
+};
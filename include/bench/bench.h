@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "perf_counters.h"
+#include "search/search_stats.h"
+
+struct BenchResult {
+    uint64_t nodes = 0;  // Sum over the suite: the build's signature, independent of thread count
+    int64_t ms = 0;
+    PerfCounters::Values events{};  // Summed over the search threads when hardware counters were requested
+    SearchStats stats;              // Per-depth tree statistics merged over the suite
+    [[nodiscard]] uint64_t nps() const { return nodes * 1000 / static_cast<uint64_t>(ms > 0 ? ms : 1); }
+};
+
+// Fixed-depth search over a built-in position suite. Each position starts from a cleared hash table, so the
+// node total only changes when the search itself does.
+class Bench {
+public:
+    static constexpr int DEFAULT_DEPTH = 5;
+    static constexpr int DEFAULT_THREADS = 1;
+    static constexpr size_t DEFAULT_HASH_MB = 16;
+
+    static const std::vector<std::string>& positions();
+
+    // Threads search different positions in parallel, each with its own Search and hash table. With perf set,
+    // each thread also collects hardware counters over its searches.
+    static BenchResult run(int depth, int threads, size_t hashMb, std::ostream& out, bool perf = false);
+};
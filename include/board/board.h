@@ -8,6 +8,8 @@
 #include "move.h"
 #include "piece_type.h"
 
+class NnueAccumulators;
+
 class Board {
 public:
     Board();
@@ -16,8 +18,27 @@ public:
     void init();
     void print() const;
     void loadFEN(const std::string& fen);
+    // Replaces the position with one bitboard per [colour][piece] in Zobrist order, bit r * 8 + c for square
+    // (r, c), no castling rights or en passant; recomputes the hashes. Throws as checkPieces does.
+    void loadPieces(const uint64_t (&pieces)[2][6], Color toMove);
+    // Throws std::invalid_argument unless no two bitboards share a square, each side has exactly one king and
+    // no pawn stands on the first or eighth rank
+    static void checkPieces(const uint64_t (&pieces)[2][6]);
     [[nodiscard]] uint64_t getHash() const { return hash; }
+    // Zobrist key of the pawns alone, for the pawn structure cache; zero when no pawns are left
+    [[nodiscard]] uint64_t getPawnHash() const { return pawnHash; }
+    // Zobrist key of the piece counts alone: every position with the same material shares it
+    [[nodiscard]] uint64_t getMaterialHash() const { return materialHash; }
+    [[nodiscard]] int pieceCount(Color color, PieceKind kind) const;
+    // White-relative sums kept up to date by makeMove: material including kings, and the early and late
+    // piece-square tables of everything but pawns (the pawn table scores those)
+    [[nodiscard]] int getMaterialScore() const { return materialScore; }
+    [[nodiscard]] int getPstEarly() const { return pstEarly; }
+    [[nodiscard]] int getPstLate() const { return pstLate; }
     void computeHash();
+    // While attached, makeMove and undoMove keep the search's NNUE accumulator stack in step. Copies start detached.
+    void attachAccumulators(NnueAccumulators* stack) { accumulators.stack = stack; }
+    [[nodiscard]] NnueAccumulators* getAccumulators() const { return accumulators.stack; }
     [[nodiscard]] std::string toFEN() const;
     bool whiteKingMoved = false;
     bool blackKingMoved = false;
@@ -31,6 +52,9 @@ public:
     bool validate(const Move& move);
     [[nodiscard]] bool squareAttacked(const Square& square, Color attackerColor) const;
     [[nodiscard]] bool isChecked(Color kingColor) const;
+    [[nodiscard]] bool givesCheck(const Move& move) const;
+    [[nodiscard]] int see(const Move& move) const;
+    [[nodiscard]] Square kingSquare(Color color) const { return color == Color::White ? whiteKing : blackKing; }
     [[nodiscard]] Color getColor() const;
     [[nodiscard]] Piece at(int r, int c) const;
     [[nodiscard]] std::optional<Move> parseUCI(const std::string& uci) const;
@@ -84,6 +108,22 @@ public:
 private:
     Piece board[8][8]{};
     Color side = Color::White;
+    Square whiteKing{-1, -1}; // Tracked on every king move so check detection needn't scan the board
+    Square blackKing{-1, -1};
+    uint64_t pawnHash = 0;
+    uint64_t materialHash = 0;
+    int8_t counts[2][6]{};  // [color][piece] in Zobrist order; kept with the hashes, so only by real moves
+    int materialScore = 0;
+    int pstEarly = 0;
+    int pstLate = 0;
+    struct AccumulatorLink {
+        NnueAccumulators* stack = nullptr;
+        AccumulatorLink() = default;
+        AccumulatorLink(const AccumulatorLink&) {}
+        AccumulatorLink& operator=(const AccumulatorLink&) { return *this; }
+    } accumulators;
+    void changeCount(int colorIdx, int pieceIdx, int delta);
+    void changeEvalTerms(const Piece& piece, int r, int c, int sign);
     void movePiece(const Square& from, const Square& to);
     void updateCastlingRights(const Piece& piece, const Move& move);
     void setAt(int r, int c, Piece p);
@@ -94,4 +134,5 @@ private:
     [[nodiscard]] bool knightAttacked(Square piece, Color attackerColor) const;
     [[nodiscard]] bool pawnAttacked(Square piece, Color attackerColor) const;
     [[nodiscard]] bool kingAttacked(Square piece, Color attackerColor) const;
+    [[nodiscard]] bool pathClear(Square from, Square to, Square vacated) const;
 };
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <random>
 #include <vector>
 #include <cstdint>
 
+#include "profiler.h"
+
 struct TTEntry {
     uint64_t hash = 0;
     int score = 0;
@@ -45,6 +48,7 @@ public:
     }
 
     TTEntry* probe(uint64_t hash) {
+        PROFILE_ZONE(TTProbe);
         TTEntry& entry = table[hash % size];
         if (entry.hash == hash && entry.depth >= 0) {
             hits++;
@@ -54,6 +58,16 @@ public:
         return nullptr;
     }
 
+    // Occupied entries per mille, sampled from the start of the table as UCI hashfull expects
+    [[nodiscard]] int hashfull() const {
+        const size_t sample = std::min<size_t>(1000, size);
+        int used = 0;
+        for (size_t i = 0; i < sample; i++) {
+            if (table[i].depth != -999) used++;
+        }
+        return static_cast<int>(used * 1000 / sample);
+    }
+
     void store(uint64_t hash, int score, int depth, uint8_t flag, const Move& bestMove) {
         TTEntry& entry = table[hash % size];
         if (depth >= entry.depth) {
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "board/board.h"
+
+// Attack bitboards for both sides, built in one pass over the board. Bit r * 8 + c is Board square (r, c), so
+// bit 0 is a8 and bit 63 is h1. Colours index [0] white, [1] black; piece kinds follow Zobrist::pieceIndex.
+struct AttackMaps {
+    // One knight, bishop, rook or queen and the squares it attacks
+    struct PieceAttacks {
+        uint64_t attacks;
+        int square;
+        PieceKind kind;
+        int color;
+    };
+    static constexpr int MAX_PIECES = 32;
+
+    uint64_t occupied = 0;
+    uint64_t byColor[2] = {};
+    uint64_t byKind[2][6] = {};
+    uint64_t attacks[2] = {};         // Every square the colour attacks
+    uint64_t attackedTwice[2] = {};   // Squares attacked by at least two of the colour's pieces
+    uint64_t pawnAttacks[2] = {};
+    PieceAttacks pieces[MAX_PIECES];
+    int pieceCount = 0;
+
+    explicit AttackMaps(const Board& board);
+
+    static uint64_t bit(const int r, const int c) { return uint64_t{1} << (r * 8 + c); }
+    static uint64_t knightAttacks(int square);
+    static uint64_t kingAttacks(int square);
+    static uint64_t bishopAttacks(int square, uint64_t occupied);
+    static uint64_t rookAttacks(int square, uint64_t occupied);
+};
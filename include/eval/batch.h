@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "board/board.h"
+
+// Positions in structure-of-arrays form for offline work such as tuning and labelling. pieces[colour][piece][i]
+// is position i's bitboard for that colour and piece, in Zobrist piece order with bit r * 8 + c for square (r, c).
+struct PositionBatch {
+    std::vector<uint64_t> pieces[2][6];
+    std::vector<Color> toMove;
+
+    [[nodiscard]] size_t size() const { return toMove.size(); }
+    void reserve(size_t n);
+    void clear();
+    // Throws std::invalid_argument for a position Board::checkPieces rejects
+    void add(const uint64_t (&position)[2][6], Color side);
+    void add(const Board& board);
+    // Loads position i into board, which is reused rather than rebuilt from a FEN
+    void load(size_t i, Board& board) const;
+};
+
+class BatchEvaluator {
+public:
+    static constexpr size_t CHUNK = 1024;  // Positions a worker claims at a time
+
+    // Writes Search::evaluate of every position, white-relative, into scores, which must match the batch size.
+    // Each worker keeps its own board and pawn and material tables across its positions; 0 threads means one per
+    // hardware thread. An invalid position throws std::invalid_argument here once every worker has stopped.
+    static void evaluate(const PositionBatch& batch, std::span<int> scores, int threads = 0);
+};
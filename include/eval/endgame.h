@@ -0,0 +1,20 @@
+#pragma once
+
+#include "board/board.h"
+
+// Whole-position evaluators for endgames the generic evaluation plays badly. Each returns a white-relative score
+// like Search::evaluate; `strong` is the side expected to win. MaterialTable picks one by material signature.
+using EndgameEval = int (*)(const Board& board, Color strong);
+
+class Endgame {
+public:
+    // Decisive but below every mate score, so a found mate still outranks it
+    static constexpr int KNOWN_WIN = 10000;
+
+    // Enough material against a bare king: drive the king to the edge and bring ours close
+    static int kxk(const Board& board, Color strong);
+    // Bishop and knight: the mate only works in a corner of the bishop's colour
+    static int kbnk(const Board& board, Color strong);
+    // King and pawn against king, exact from the KPK bitbase
+    static int kpk(const Board& board, Color strong);
+};
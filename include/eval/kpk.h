@@ -0,0 +1,15 @@
+#pragma once
+
+#include "pieces.h"
+
+// King and pawn versus king bitbase, built once by retrograde analysis (about 200K positions, 192 KB).
+// Squares are 0-63 with a1 = 0 and h8 = 63, seen from the side with the pawn, which moves towards rank 8.
+class KPK {
+public:
+    // Built on first probe if not before; call at startup to keep the cost out of the first search
+    static void init();
+
+    // Whether the pawn side wins with best play. strongToMove says whose turn it is. Kings must be on the board
+    // and the pawn on ranks 2-7.
+    static bool probe(bool strongToMove, int strongKing, int pawn, int weakKing);
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board/board.h"
+#include "eval/endgame.h"
+
+// Everything evaluate() needs that depends on the piece counts alone
+struct MaterialEntry {
+    static constexpr int SCALE_NORMAL = 64;
+
+    uint64_t key = 0;
+    int phase = 0;                 // Non-pawn material on the 0 to MAX_PHASE scale; can exceed it after promotions
+    int imbalance = 0;             // White-relative material-combination terms
+    uint8_t scale[2] = {SCALE_NORMAL, SCALE_NORMAL};  // [colour]: out of SCALE_NORMAL, applied when it is ahead
+    bool deadDraw = false;         // Neither side has mating material
+    EndgameEval endgame = nullptr; // Replaces the generic evaluation when set
+    Color strong = Color::White;   // The side the endgame evaluator plays for
+};
+
+// Direct-mapped cache of MaterialEntry keyed by Board::getMaterialHash(). A game passes through few material
+// signatures, so a small table nearly always hits.
+class MaterialTable {
+    std::vector<MaterialEntry> table;
+    uint64_t mask;
+
+public:
+    static constexpr size_t DEFAULT_ENTRIES = size_t{1} << 12;
+    static constexpr int BISHOP_PAIR = 30;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    explicit MaterialTable(size_t entries = DEFAULT_ENTRIES);
+    void clear();
+
+    // The entry for the board's material, computed and stored on a miss
+    const MaterialEntry& probe(const Board& board);
+    static MaterialEntry compute(const Board& board);
+};
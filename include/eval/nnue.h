@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "board/board.h"
+
+// HalfKP network: each side's feature transformer sees every non-king piece relative to that side's own king.
+// Layers: 40960 inputs -> 2 x L1 int16 accumulators -> clipped to [0, 127] -> L2 -> clipped -> 1 output.
+//
+// File format, little-endian: "NNUE", uint32 version, uint32 INPUTS, L1 and L2, then
+// int16 ftBias[L1], int16 ftWeight[INPUTS][L1], int32 hiddenBias[L2], int8 hiddenWeight[L2][2 * L1],
+// int32 outputBias, int8 outputWeight[L2].
+struct NnueArch {
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int PIECE_FEATURES = 10;                // Pawn to queen, ours and theirs
+    static constexpr int INPUTS = 64 * PIECE_FEATURES * 64;  // [king square][piece][square]
+    static constexpr int L1 = 128;
+    static constexpr int L2 = 32;
+    static constexpr int CLIP = 127;
+    static constexpr int HIDDEN_SHIFT = 6;                   // Hidden sums carry weight scale 64
+    static constexpr int OUTPUT_DIVISOR = 16;                // Output units per centipawn
+
+    // Feature index of a non-king piece (Zobrist piece order) seen from perspective's king; colours 0 white, 1 black
+    static int feature(int perspective, int kingSquare, int piece, int color, int square);
+};
+
+// First-layer sums for both perspectives at one ply, plus the piece changes of the move that led to it
+struct NnueAccumulator {
+    struct Change {
+        int8_t piece;   // Zobrist piece order
+        int8_t color;
+        int8_t square;  // r * 8 + c
+        int8_t sign;    // +1 added, -1 removed
+    };
+    static constexpr int MAX_CHANGES = 4;  // Castling moves two pieces
+
+    alignas(32) int16_t values[2][NnueArch::L1];
+    bool computed[2] = {};
+    bool kingMoved[2] = {};  // That side's accumulator can't be updated across this move and is rebuilt instead
+    Change changes[MAX_CHANGES];
+    int changeCount = 0;
+};
+
+// Per-ply accumulators for one search. While attached to a Board, makeMove pushes a ply recording its piece
+// changes and undoMove pops it; the sums themselves are only brought up to date when a position is evaluated.
+class NnueAccumulators {
+public:
+    static constexpr int CAPACITY = 256;
+
+    NnueAccumulators() : stack(CAPACITY) {}
+    // Starts over at the board's position; its sums are rebuilt on the next evaluation
+    void reset();
+    void push();
+    void pop();
+    void change(int piece, int color, int square, int sign);
+    [[nodiscard]] int size() const { return top + 1; }
+
+private:
+    friend class NnueNetwork;
+    std::vector<NnueAccumulator> stack;
+    int top = 0;
+};
+
+class NnueNetwork {
+public:
+    // Throws std::runtime_error when the file is missing, truncated or for a different architecture
+    static std::shared_ptr<const NnueNetwork> load(const std::string& path);
+    // Small random weights; for tests and for checking a trainer's exporter against this loader
+    static std::shared_ptr<NnueNetwork> random(uint64_t seed);
+    void save(const std::string& path) const;
+
+    // White-relative score in centipawns, bringing the accumulators up to date from the last computed ply
+    int evaluate(const Board& board, NnueAccumulators& accumulators) const;
+    // The same without accumulators: both sides' sums are built from scratch
+    int evaluate(const Board& board) const;
+
+private:
+    std::vector<int16_t> ftBias;
+    std::vector<int16_t> ftWeight;
+    std::vector<int32_t> hiddenBias;
+    std::vector<int8_t> hiddenWeight;
+    int32_t outputBias = 0;
+    std::vector<int8_t> outputWeight;
+
+    NnueNetwork();
+    void refresh(const Board& board, int perspective, int16_t* values) const;
+    void update(const Board& board, NnueAccumulators& accumulators, int perspective) const;
+    [[nodiscard]] int propagate(const Board& board, const int16_t (&values)[2][NnueArch::L1]) const;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board/board.h"
+
+// Evaluation terms that depend on nothing but the pawns. A zeroed entry is exactly the entry of a pawnless
+// board (key 0), so the cleared table needs no separate "empty" marker.
+struct PawnEntry {
+    enum Wing { Kingside, Queenside };
+
+    uint64_t key = 0;
+    int score = 0;              // White-relative pawn square tables and passed-pawn bonuses
+    uint8_t shield[2][2] = {};  // [colour][Wing]: pawns in front of a king castled on that wing
+};
+
+// Direct-mapped cache of PawnEntry keyed by Board::getPawnHash(). Pawn structure changes on few moves, so
+// nearly every evaluation finds its entry.
+class PawnTable {
+    std::vector<PawnEntry> table;
+    uint64_t mask;
+
+public:
+    static constexpr size_t DEFAULT_ENTRIES = size_t{1} << 14;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    explicit PawnTable(size_t entries = DEFAULT_ENTRIES);
+    void clear();
+
+    // The entry for the board's pawns, computed and stored on a miss
+    const PawnEntry& probe(const Board& board);
+    static PawnEntry compute(const Board& board);
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// Evaluation kernels in AVX2, SSE4.2 and scalar versions. The build targets baseline x86-64, so the vector
+// versions are compiled per function and the best one the CPU supports is picked once at startup.
+class Simd {
+public:
+    enum class Level : uint8_t { Scalar, Sse42, Avx2 };
+
+    // Most capable level this CPU supports
+    static Level detect();
+    static Level level();
+    // Falls back to the best supported level at or below the one asked for; returns the level now in use
+    static Level setLevel(Level requested);
+    static const char* name(Level level);
+
+    // Sum of popcount(bits[i]) * weights[i] over n entries
+    static int weightedPopcount(const uint64_t* bits, const int16_t* weights, int n);
+    // The same with an explicit level, for tests and benchmarks; the level must be supported
+    static int weightedPopcount(Level level, const uint64_t* bits, const int16_t* weights, int n);
+};
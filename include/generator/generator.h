@@ -6,10 +6,15 @@
 
 class Generator {
 public:
+    // The untemplated forms dispatch on the side to move. The search calls the Side forms directly; they append
+    // to a caller's buffer so a reused buffer stops allocating once it has grown.
     static std::vector<Move> generatePseudoMoves(Board& board);
+    template<Color Side> static void generatePseudoMoves(Board& board, std::vector<Move>& moves);
 
     static void generateSlidingCaptures(const Board& board, int r, int c,
                                         std::vector<Move>& captures, Color enemy,
                                         bool diagonal, bool orthogonal);
+    // Captures, en passant and quiet queen promotions: the tactical moves quiescence looks at
     static std::vector<Move> generateCaptures(const Board& board);
+    template<Color Side> static void generateCaptures(const Board& board, std::vector<Move>& captures);
 };
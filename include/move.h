@@ -8,6 +8,7 @@ struct Square {
     int c;
     Square() = default;
     Square(int row, int col) : r(row), c(col) {}
+    bool operator==(const Square&) const = default;
 };
 
 enum class MoveType { Normal, Castle, EnPassant, Promotion };
@@ -21,6 +22,7 @@ struct Move {
     Move() = default;
     Move(const Square c, const Square d, const MoveType t = MoveType::Normal, const PieceKind p = PieceKind::None)
     : current(c), destination(d), promotion(p), type(t) {}
+    bool operator==(const Move&) const = default;
 };
 
 struct MoveUndo {
@@ -29,6 +31,11 @@ struct MoveUndo {
     Piece movedPiece{};
     std::optional<Square> enPassantTarget = std::nullopt;
     uint64_t prevHash{};
+    uint64_t prevPawnHash{};
+    uint64_t prevMaterialHash{};
+    int prevMaterialScore{};
+    int prevPstEarly{};
+    int prevPstLate{};
 
     bool whiteKingMoved{};
     bool blackKingMoved{};
@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+enum class PerfEvent : uint8_t {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1DMisses,
+    LLCMisses,
+    DTLBMisses,
+    Count
+};
+
+// Hardware counters for the calling thread through Linux perf_event_open, user space only. Each event is
+// opened on its own so one the CPU or VM lacks doesn't take the others down, and readings are scaled if
+// the kernel had to multiplex them. Off Linux, or when the kernel refuses (perf_event_paranoid, containers),
+// the events are unavailable and read as zero.
+class PerfCounters {
+public:
+    static constexpr size_t EVENTS = static_cast<size_t>(PerfEvent::Count);
+    static constexpr const char* NAMES[EVENTS] = {
+        "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses", "dTLB-misses"
+    };
+    using Values = std::array<uint64_t, EVENTS>;
+
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool available() const;
+    [[nodiscard]] bool available(PerfEvent event) const { return fds[static_cast<size_t>(event)] >= 0; }
+    // Running totals since construction; callers diff two reads
+    [[nodiscard]] Values read() const;
+
+    // name=value pairs plus IPC, skipping events that couldn't be opened
+    static void print(const Values& values, std::ostream& out);
+
+private:
+    std::array<int, EVENTS> fds{};
+};
@@ -7,9 +7,16 @@
 class Pawn : public ChessPiece {
 public:
     void generateMoves(Board &board, int row, int col, std::vector<Move> &moves) const override {
-        const Piece pawn = board.at(row, col);
-        const int direction = pawn.color == Color::White ? -1 : 1; // Pawn Movement Direction
-        const int eligibility = pawn.color == Color::White ? 6 : 1; // Eligibility to Jump twice
+        if (board.at(row, col).color == Color::White) generate<Color::White>(board, row, col, moves);
+        else generate<Color::Black>(board, row, col, moves);
+    }
+
+    template<Color Us>
+    static void generate(Board &board, int row, int col, std::vector<Move> &moves) {
+        constexpr Color opponent = Us == Color::White ? Color::Black : Color::White;
+        constexpr int direction = Us == Color::White ? -1 : 1; // Pawn Movement Direction
+        constexpr int eligibility = Us == Color::White ? 6 : 1; // Eligibility to Jump twice
+        constexpr int promotionRow = Us == Color::White ? 0 : 7;
         for (const auto [dr, dc] : MovementConst::MINKOWSKI_RESTRICTED_SUM) {
             if (dr == 2 && row != eligibility) continue; // Not on the eligible rank to jump twice
             if (dr == 2 && board.at(row + direction, col).kind != PieceKind::None) continue; // Intercepted by a piece
@@ -19,9 +26,9 @@ public:
             if (r >= 0 && r < 8 && c >= 0 && c < 8) {
                 const auto [kind, color] = board.at(r, c);
                 if (dc == 0 && kind != PieceKind::None) continue;
-                if (dc != 0 && (pawn.color == color || color == Color::None)) continue;
+                if (dc != 0 && color != opponent) continue;
 
-                if (r == 0 || r == 7) {
+                if (r == promotionRow) {
                     for (PieceKind promo : {PieceKind::Queen, PieceKind::Rook, PieceKind::Bishop, PieceKind::Knight}) {
                         moves.emplace_back(Square(row, col), Square(r, c), MoveType::Promotion, promo);
                     }
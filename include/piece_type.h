@@ -149,6 +149,7 @@ constexpr int pawnPST[8][8] = {
 };
 
 constexpr int MATE = 100000000;
+constexpr int MATE_BOUND = MATE - 1000; // Anything beyond this is a forced mate score
 constexpr int INF = 1'000'000'000;
 constexpr int PHASE_KNIGHT = 1;
 constexpr int PHASE_BISHOP = 1;
@@ -1,50 +1,278 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <string>
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
-struct ProfileStats {
-    long long ns = 0;
-    long long calls = 0;
+#include "perf_counters.h"
+#include "trace.h"
+
+// Zones are fixed at compile time: entering one costs two timestamp reads and a few thread-local adds.
+// Configure with -DCHESS_PROFILE=ON to compile them in; otherwise PROFILE_ZONE expands to nothing.
+// Profiler::enablePerf additionally attributes hardware counters to zones. That costs a few syscalls per zone,
+// so it is for comparing cache and branch behaviour between builds, not for timing.
+// Profiler::enableTrace records every zone entry and exit into per-thread ring buffers for timeline export.
+enum class ProfileZone : uint8_t {
+    AlphaBeta,
+    Quiescence,
+    Evaluate,
+    GenerateMoves,
+    GenerateCaptures,
+    MakeMove,
+    UndoMove,
+    TTProbe,
+    See,
+    Count
+};
+
+// One thread's totals per zone
+struct ProfileCounters {
+    static constexpr size_t ZONES = static_cast<size_t>(ProfileZone::Count);
+    std::array<std::atomic<uint64_t>, ZONES> ticks{};
+    std::array<std::atomic<uint64_t>, ZONES> calls{};
+    std::array<std::array<std::atomic<uint64_t>, PerfCounters::EVENTS>, ZONES> events{};
 };
 
 class Profiler {
+    using Counters = ProfileCounters;
+    struct Sample {
+        uint64_t ticks = 0;
+        uint64_t calls = 0;
+        PerfCounters::Values events{};
+    };
+
 public:
-    static inline std::unordered_map<std::string, ProfileStats> stats;
+#ifdef CHESS_PROFILE
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+    static constexpr size_t ZONES = ProfileCounters::ZONES;
+    static constexpr const char* NAMES[ZONES] = {
+        "alphaBeta", "quiescence", "evaluate", "generatePseudoMoves", "generateCaptures",
+        "makeMove", "undoMove", "tt.probe", "see"
+    };
+
+    // TSC ticks where available, nanoseconds otherwise; print() converts either to time
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static void add(ProfileZone zone, uint64_t ticks, const PerfCounters::Values* events = nullptr) {
+        Counters& counters = local().counters;
+        const size_t i = static_cast<size_t>(zone);
+        bump(counters.ticks[i], ticks);
+        bump(counters.calls[i], 1);
+        if (events) {
+            for (size_t e = 0; e < PerfCounters::EVENTS; e++) bump(counters.events[i][e], (*events)[e]);
+        }
+    }
+
+    static void enablePerf(bool enabled) { perfEnabled.store(enabled, std::memory_order_relaxed); }
+    static bool perfEnabledNow() { return perfEnabled.load(std::memory_order_relaxed); }
+
+    static void enableTrace(bool enabled) { traceEnabled.store(enabled, std::memory_order_relaxed); }
+    static bool traceEnabledNow() { return traceEnabled.load(std::memory_order_relaxed); }
+
+    // This thread's trace buffer, created and registered on first use. Buffers outlive their threads so a
+    // bench's workers can be exported after they have been joined.
+    static TraceBuffer& traceBuffer() {
+        ThreadCounters& thread = local();
+        if (!thread.trace) {
+            std::lock_guard lock(mutex);
+            thread.trace = std::make_shared<TraceBuffer>(static_cast<uint32_t>(traces.size()));
+            traces.push_back(thread.trace);
+        }
+        return *thread.trace;
+    }
+
+    // Chrome trace JSON and folded stacks of everything recorded since the last reset
+    static void writeTrace(std::ostream& chrome, std::ostream& folded) {
+        const double ticksPerUs = tickRate() * 1000.0;
+        std::lock_guard lock(mutex);
+        std::vector<const TraceBuffer*> buffers;
+        for (const auto& trace : traces) buffers.push_back(trace.get());
+        TraceWriter::writeChrome(buffers, NAMES, ticksPerUs, chrome);
+        TraceWriter::writeFolded(buffers, NAMES, ticksPerUs, folded);
+    }
+
+    // This thread's hardware counters, opened on first use
+    static PerfCounters::Values readPerf() {
+        ThreadCounters& thread = local();
+        if (!thread.perf) thread.perf = std::make_unique<PerfCounters>();
+        return thread.perf->read();
+    }
+
+    // Totals over every thread that has recorded anything, including threads that have since exited
+    static uint64_t calls(ProfileZone zone) { return total(zone).calls; }
+    static uint64_t ticks(ProfileZone zone) { return total(zone).ticks; }
 
-    static void add(const std::string& name, long long ns) {
-        auto& s = stats[name];
-        s.ns += ns;
-        s.calls += 1;
+    static void reset() {
+        std::lock_guard lock(mutex);
+        for (Counters* counters : live) clear(*counters);
+        clear(retired);
+        for (const auto& trace : traces) trace->clear();
+        startTicks = now();
+        startTime = std::chrono::steady_clock::now();
     }
 
-    static void print() {
-        std::cout << "\n==== PROFILER RESULTS ====\n";
-        for (auto& [name, s] : stats) {
-            double ms = s.ns / 1e6;
-            double avg_us = (s.calls ? (s.ns / 1e3) / (double)s.calls : 0.0);
-            std::cout << name
-                      << " : " << ms << " ms"
-                      << " | calls=" << s.calls
-                      << " | avg=" << avg_us << " us\n";
+    static void print(std::ostream& out = std::cout) {
+        const double ticksPerNs = tickRate();
+
+        out << "\n==== PROFILER RESULTS (self time) ====\n";
+        for (size_t i = 0; i < ZONES; i++) {
+            const Sample sample = total(static_cast<ProfileZone>(i));
+            if (sample.calls == 0) continue;
+            const double ns = static_cast<double>(sample.ticks) / ticksPerNs;
+            out << NAMES[i]
+                << " : " << ns / 1e6 << " ms"
+                << " | calls=" << sample.calls
+                << " | avg=" << ns / static_cast<double>(sample.calls) << " ns\n";
+            if (perfEnabledNow() && std::ranges::any_of(sample.events, [](uint64_t v) { return v > 0; })) {
+                out << "    ";
+                PerfCounters::print(sample.events, out);
+                out << "\n";
+            }
+        }
+        out << "======================================\n";
+    }
+
+private:
+    // Each thread owns its counters and registers them for reporting; on exit they fold into `retired`
+    struct ThreadCounters {
+        Counters counters;
+        std::unique_ptr<PerfCounters> perf;
+        std::shared_ptr<TraceBuffer> trace;
+        ThreadCounters() {
+            std::lock_guard lock(mutex);
+            live.push_back(&counters);
+        }
+        ~ThreadCounters() {
+            std::lock_guard lock(mutex);
+            for (size_t i = 0; i < ZONES; i++) {
+                bump(retired.ticks[i], counters.ticks[i].load(std::memory_order_relaxed));
+                bump(retired.calls[i], counters.calls[i].load(std::memory_order_relaxed));
+                for (size_t e = 0; e < PerfCounters::EVENTS; e++) {
+                    bump(retired.events[i][e], counters.events[i][e].load(std::memory_order_relaxed));
+                }
+            }
+            std::erase(live, &counters);
         }
-        std::cout << "==========================\n";
+    };
+
+    static inline std::mutex mutex;
+    static inline std::vector<Counters*> live;
+    static inline Counters retired;
+    static inline std::atomic<bool> perfEnabled{false};
+    static inline std::atomic<bool> traceEnabled{false};
+    static inline std::vector<std::shared_ptr<TraceBuffer>> traces;
+    static inline uint64_t startTicks = now();
+    static inline std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    // Ticks per nanosecond, measured against the wall clock since the last reset
+    static double tickRate() {
+        const double elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+        return elapsedNs > 0 ? static_cast<double>(now() - startTicks) / elapsedNs : 1.0;
     }
 
-    static void reset() { stats.clear(); }
+    static ThreadCounters& local() {
+        thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    // Only the owning thread writes a counter, so a relaxed load and store is enough and avoids a locked add
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static void clear(Counters& counters) {
+        for (size_t i = 0; i < ZONES; i++) {
+            counters.ticks[i].store(0, std::memory_order_relaxed);
+            counters.calls[i].store(0, std::memory_order_relaxed);
+            for (auto& event : counters.events[i]) event.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static Sample total(ProfileZone zone) {
+        const size_t i = static_cast<size_t>(zone);
+        std::lock_guard lock(mutex);
+        Sample sample{retired.ticks[i].load(std::memory_order_relaxed), retired.calls[i].load(std::memory_order_relaxed)};
+        for (size_t e = 0; e < PerfCounters::EVENTS; e++) sample.events[e] = retired.events[i][e].load(std::memory_order_relaxed);
+        for (const Counters* counters : live) {
+            sample.ticks += counters->ticks[i].load(std::memory_order_relaxed);
+            sample.calls += counters->calls[i].load(std::memory_order_relaxed);
+            for (size_t e = 0; e < PerfCounters::EVENTS; e++) {
+                sample.events[e] += counters->events[i][e].load(std::memory_order_relaxed);
+            }
+        }
+        return sample;
+    }
 };
 
-class ScopedTimer {
-    using Clock = std::chrono::high_resolution_clock;
-    std::string name;
-    Clock::time_point start;
+// Records the time spent in a scope minus the time spent in zones nested inside it, so recursive zones like
+// alphaBeta aren't counted once per ply and the zone totals add up to the profiled time.
+class ScopedZone {
+    ProfileZone zone;
+    bool perf;
+    bool trace;
+    PerfCounters::Values startEvents{};
+    PerfCounters::Values childEvents{};
+    uint64_t start;
+    uint64_t childTicks = 0;
+    ScopedZone* parent;
+    static inline thread_local ScopedZone* current = nullptr;
 
 public:
-    ScopedTimer(std::string n) : name(std::move(n)), start(Clock::now()) {}
-    ~ScopedTimer() {
-        auto end = Clock::now();
-        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-        Profiler::add(name, ns);
+    explicit ScopedZone(ProfileZone z)
+        : zone(z), perf(Profiler::perfEnabledNow()), trace(Profiler::traceEnabledNow()), parent(current) {
+        if (perf) startEvents = Profiler::readPerf();
+        start = Profiler::now();
+        if (trace) Profiler::traceBuffer().record(start, static_cast<uint8_t>(zone), true);
+        current = this;
+    }
+    ~ScopedZone() {
+        const uint64_t stop = Profiler::now();
+        const uint64_t elapsed = stop - start;
+        if (trace) Profiler::traceBuffer().record(stop, static_cast<uint8_t>(zone), false);
+        if (perf) {
+            const PerfCounters::Values end = Profiler::readPerf();
+            PerfCounters::Values self{};
+            for (size_t e = 0; e < PerfCounters::EVENTS; e++) {
+                // Multiplexed counters are scaled estimates and can step backwards slightly
+                const uint64_t delta = end[e] > startEvents[e] ? end[e] - startEvents[e] : 0;
+                self[e] = delta > childEvents[e] ? delta - childEvents[e] : 0;
+                if (parent) parent->childEvents[e] += delta;
+            }
+            Profiler::add(zone, elapsed - childTicks, &self);
+        } else {
+            Profiler::add(zone, elapsed - childTicks);
+        }
+        if (parent) parent->childTicks += elapsed;
+        current = parent;
     }
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
 };
+
+#ifdef CHESS_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(zone) const ScopedZone PROFILE_CONCAT(profileZone_, __LINE__)(ProfileZone::zone)
+#else
+#define PROFILE_ZONE(zone) static_cast<void>(0)
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Direct-mapped cache of static evaluations keyed by the Zobrist hash. evaluate() depends only on the position,
+// so an entry never goes stale and a hit returns exactly what evaluating again would. A new position simply
+// overwrites its slot. Hash 0 is never stored, which lets the cleared table double as "empty".
+class EvalCache {
+    struct Entry {
+        uint64_t hash = 0;
+        int score = 0;
+    };
+    std::vector<Entry> table;
+    uint64_t mask;
+
+public:
+    static constexpr size_t DEFAULT_ENTRIES = size_t{1} << 16;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    // Rounded down to a power of two so the slot is a mask rather than a division
+    explicit EvalCache(size_t entries = DEFAULT_ENTRIES) {
+        size_t size = 1;
+        while (size * 2 <= entries) size *= 2;
+        table.resize(size);
+        mask = size - 1;
+    }
+
+    void clear() {
+        for (auto& entry : table) entry = Entry{};
+        hits = 0;
+        misses = 0;
+    }
+
+    bool probe(const uint64_t hash, int& score) {
+        const Entry& entry = table[hash & mask];
+        if (hash != 0 && entry.hash == hash) {
+            hits++;
+            score = entry.score;
+            return true;
+        }
+        misses++;
+        return false;
+    }
+
+    void store(const uint64_t hash, const int score) {
+        if (hash == 0) return;
+        table[hash & mask] = {hash, score};
+    }
+};
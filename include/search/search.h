@@ -2,28 +2,172 @@
 #include "board/board.h"
 #include "move.h"
 #include "board/transposition.h"
+#include "search/eval_cache.h"
+#include "eval/pawn_table.h"
+#include "eval/material.h"
+#include "eval/nnue.h"
+#include "search/search_stats.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <tuple>
 
+constexpr int MAX_PLY = 128;
+
+// Tunable margins for the shallow-depth pruning in alphaBeta. Arrays are indexed by remaining depth.
+struct SearchParams {
+    int reverseFutilityDepth = 3;
+    int reverseFutilityMargin = 120;  // Per ply of remaining depth
+
+    int futilityDepth = 3;
+    int futilityMargin[4] = {0, 150, 300, 500};
+
+    int razorDepth = 2;
+    int razorMargin[3] = {0, 400, 800};
+
+    // Singular extensions: the TT move is extended when nothing else gets within margin * depth of its score
+    int singularDepth = 4;
+    int singularMargin = 15;
+
+    // Internal iterative reduction: nodes this deep with no TT move are searched one ply shallower
+    int iirDepth = 4;
+
+    // ProbCut: a winning capture that still beats beta + margin at reduced depth cuts the node
+    int probCutDepth = 5;
+    int probCutMargin = 200;
+    int probCutReduction = 4;
+
+    // Quiescence delta pruning: skip a capture if winning the victim plus this margin can't reach alpha
+    int deltaMargin = 200;
+};
+
+// What `go` asked for. Zero means the limit is not set.
+struct SearchLimits {
+    int depth = 0;
+    int64_t movetime = 0;       // Exact time for this move, ms
+    int64_t wtime = 0;          // Remaining clocks and increments, ms
+    int64_t btime = 0;
+    int64_t winc = 0;
+    int64_t binc = 0;
+    int movestogo = 0;
+    uint64_t nodes = 0;         // Stop after this many nodes; with no time limit the result is reproducible
+};
+
+// A legal root move and what the iterations so far learned about it. Scores are from the root side's view.
+struct RootMove {
+    explicit RootMove(const Move& m) : move(m) {}
+    Move move;
+    int score = -INF;
+    uint64_t nodes = 0;         // Nodes spent below this move across all iterations
+    std::vector<Move> pv;
+};
 
 class Search {
 public:
-    Search() : tt(64) {};
-    void clearTT() { tt.clear(); };
+    explicit Search(size_t hashMb = 64) : tt(hashMb) {
+        // Grown once here so the search itself never has to
+        for (auto& buffer : moveBuffers) buffer.reserve(MOVE_BUFFER_RESERVE);
+        for (auto& buffer : auxBuffers) buffer.reserve(MOVE_BUFFER_RESERVE);
+    };
+    void resizeTT(size_t hashMb) { tt = TranspositionTable(hashMb); };
+    void clearTT() {
+        tt.clear();
+        evalCache.clear();
+        pawnTable.clear();
+        materialTable.clear();
+    };
     void resetTTStats() { tt.resetStats(); };
     std::tuple<uint64_t, uint64_t, uint64_t> getTTStats() {
         return {tt.hits, tt.misses, tt.stores};
     };
+    // The entry stored for a position, if any; for tests and debugging
+    [[nodiscard]] const TTEntry* probeTT(uint64_t hash) { return tt.probe(hash); }
     int rootDepth{};
+    SearchParams params;
     Move findBestMove(Board& board, int depth);
-    static int evaluate(const Board& board);
+    Move findBestMove(Board& board, const SearchLimits& limits);
+    // White-relative static evaluation. Pawn and material terms come from the tables when given, otherwise they
+    // are computed. Recognised endgames are handed to their specialised evaluator.
+    static int evaluate(const Board& board, PawnTable* pawnTable = nullptr, MaterialTable* materialTable = nullptr);
+    // Tiered evaluation against a white-relative window: returns the cheap tier (material, piece-square tables,
+    // pawn and material entries) with exact cleared when it is LAZY_MARGIN beyond the window
+    static int evaluate(const Board& board, PawnTable* pawnTable, MaterialTable* materialTable, int alpha, int beta,
+                        bool& exact);
+    // Empirical, not a bound: the expensive terms moved the score by more than 300 in about one evaluation in
+    // 2.6 million over the bench suite. A lazy score past the margin can therefore, rarely, be on the wrong side of
+    // the window, and quiescence stands pat and delta-prunes on it.
+    static constexpr int LAZY_MARGIN = 350;
+    [[nodiscard]] uint64_t getNodes() const { return nodes; }
+    // Per-depth tree statistics of the last search; only completed iterations are kept
+    [[nodiscard]] const SearchStats& getStats() const { return stats; }
+    // Root moves of the last search, best first, with scores and PVs from its last completed iteration
+    [[nodiscard]] const std::vector<RootMove>& getRootMoves() const { return rootMoves; }
+    void setMultiPV(int lines) { multiPV = std::clamp(lines, 1, MAX_MULTI_PV); }
+    void setInfoOutput(bool enabled) { infoOutput = enabled; }
+    // NNUE replaces the handcrafted evaluation when a network is set and enabled; dead draws and the specialised
+    // endgame evaluators still take precedence. Either change clears the evaluation cache and the TT.
+    void setNetwork(std::shared_ptr<const NnueNetwork> net);
+    void setUseNnue(bool enabled);
+    [[nodiscard]] bool nnueActive() const { return useNnue && network; }
+    static constexpr int MAX_MULTI_PV = 64;
 private:
+    static constexpr int64_t INFO_INTERVAL_MS = 50;  // Quick iterations are not all worth a line
+    static constexpr int64_t MOVE_OVERHEAD_MS = 30;  // Kept back from the clock for I/O and GUI latency
+
     TranspositionTable tt;
+    EvalCache evalCache;
+    PawnTable pawnTable;
+    MaterialTable materialTable;
+    std::shared_ptr<const NnueNetwork> network;
+    std::unique_ptr<NnueAccumulators> accumulators;  // Allocated with the first network
+    bool useNnue = false;
+    uint64_t nodes = 0;
+    int selDepth = 0;
+    int multiPV = 1;
+    bool infoOutput = true;
+    std::chrono::steady_clock::time_point searchStart;
+    std::vector<RootMove> rootMoves;
+    std::vector<RootMove> completedRootMoves;  // rootMoves as the last complete iteration left them
+
+    // Time management. optimumTime is where we'd like to stop between iterations, maximumTime aborts mid-search.
+    int64_t optimumTime = 0;
+    int64_t maximumTime = 0;
+    uint64_t nodeLimit = 0;
+    bool stopped = false;
+
+    SearchStats stats;
+    DepthStats scratchStats;                  // Absorbs counts outside a recorded iteration
+    DepthStats* iterationStats = &scratchStats;
+
+    // Per-ply move lists reused by alphaBeta and quiescence: moveBuffers for the node's own moves, auxBuffers for
+    // ProbCut captures and quiescence's quiet-check scan
+    static constexpr size_t MOVE_BUFFER_RESERVE = 256;
+    std::vector<Move> moveBuffers[MAX_PLY + 1];
+    std::vector<Move> auxBuffers[MAX_PLY + 1];
+
+    // Triangular PV table: row ply holds the best line found from that ply
+    Move pvTable[MAX_PLY + 1][MAX_PLY + 1];
+    int pvLength[MAX_PLY + 1]{};
+
     int currentPST[6][64];  // [pieceKind][square]
     double lastPhase = -1;
-    int alphaBeta(Board& board, int depth, int ply, int alpha, int beta);
+    void initRootMoves(Board& board);
+    void searchRoot(Board& board, int depth, size_t pvIdx);
+    void allocateTime(const SearchLimits& limits, Color side);
+    bool shouldStop();
+    template<Color Us> int alphaBeta(Board& board, int depth, int ply, int alpha, int beta, const Move* excluded = nullptr);
+    void updatePv(int ply, const Move& move);
+    void extendPvFromTT(Board& board, std::vector<Move>& pv, int depth);
+    [[nodiscard]] int64_t elapsedMs() const;
+    void printInfo(int depth, int multipv, const RootMove& rootMove);
+    // Window is white-relative; outside the full window the result may be the cheap tier alone
+    int cachedEvaluate(const Board& board, int alpha = -INF, int beta = INF);
+
     static int computePhase(const Board& board);
     static int mvvLva(const Move& move, const Board& board);
+    static bool isQuiet(const Move& move, const Board& board);
     static void orderMoves(std::vector<Move>& moves, const Board& board);
-    int quiescence(Board& board, int alpha, int beta, int qDepth = 0);
+    template<Color Us> int quiescence(Board& board, int alpha, int beta, int ply, int qDepth = 0);
     void updatePST(double phase);
-};
\ No newline at end of file
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "alloc_tracker.h"
+
+// Tree-shape counters for one iterative-deepening iteration. Nodes are alphaBeta nodes; quiescence nodes are
+// counted separately. TT cutoffs are indexed by TTFlag.
+struct DepthStats {
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;
+    uint64_t moveLoops = 0;          // Nodes that got as far as searching moves
+    uint64_t betaCutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;   // Cutoffs produced by the first legal move searched
+    uint64_t ttCutoffs[3] = {};
+    uint64_t reverseFutility = 0;
+    uint64_t razoring = 0;
+    uint64_t futilityPrunes = 0;     // Quiet moves skipped at futile nodes
+    uint64_t probCuts = 0;
+    uint64_t singularExtensions = 0;
+    uint64_t multiCuts = 0;
+    uint64_t checkExtensions = 0;
+    uint64_t iirReductions = 0;
+    uint64_t deltaPrunes = 0;
+    uint64_t seePrunes = 0;          // Losing captures skipped in quiescence
+    uint64_t evaluations = 0;        // Static evaluations requested, including those served by the eval cache
+    uint64_t evalCacheHits = 0;
+    uint64_t pawnTableHits = 0;      // Of the evaluations the eval cache missed
+    uint64_t lazyEvals = 0;          // Evaluations that stopped after the cheap tier
+
+    void merge(const DepthStats& other);
+};
+
+// Heap allocations by search phase; only recorded in CHESS_ALLOC_TRACKING builds. The tree is everything under
+// the root move loop and should stay at zero.
+struct AllocStats {
+    AllocCounts setup;   // Root move generation
+    AllocCounts tree;    // alphaBeta and quiescence below the root
+    AllocCounts pv;      // Copying and extending root PVs
+    AllocCounts output;  // info lines
+
+    void merge(const AllocStats& other);
+    void print(std::ostream& out, uint64_t nodes) const;
+};
+
+// Per-depth statistics of the last search, or of several searches merged (bench)
+struct SearchStats {
+    std::vector<DepthStats> depths;  // depths[d - 1] is iteration d
+    AllocStats allocs;
+
+    void clear() {
+        depths.clear();
+        allocs = {};
+    }
+    void merge(const SearchStats& other);
+    // One row per depth with cutoff rates and effective branching factor, then a key=value line per depth
+    void print(std::ostream& out) const;
+};
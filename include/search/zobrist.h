@@ -14,6 +14,9 @@ public:
     static uint64_t sideToMove;
     static uint64_t castling[16]; // castling rights as a 4-bit bitmask
     static uint64_t enPassant[8]; // enpassant rights as a 2-bit bitmask
+    static uint64_t exclusion; // keys excluded-move searches apart from the full node in the TT
+    static constexpr int MAX_COUNT = 16;
+    static uint64_t material[2][6][MAX_COUNT + 1];  // [color][piece][count], for the material signature
 
     static int colorIndex(Color c) { return c == Color::White ? 0 : 1; }
 
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct TraceEvent {
+    uint64_t ticks;
+    uint8_t zone;
+    bool begin;
+};
+
+// One thread's timeline of zone begin/end events. Only the owning thread writes, so recording is a store and
+// a release of the head index; when full, the oldest events are overwritten.
+class TraceBuffer {
+public:
+    static constexpr size_t CAPACITY = size_t{1} << 21;  // 32 MB per thread
+
+    explicit TraceBuffer(uint32_t threadId) : threadId(threadId), events(CAPACITY) {}
+
+    void record(uint64_t ticks, uint8_t zone, bool begin) {
+        const uint64_t i = head.load(std::memory_order_relaxed);
+        events[i & (CAPACITY - 1)] = {ticks, zone, begin};
+        head.store(i + 1, std::memory_order_release);
+    }
+
+    // Oldest first. Meant for after the search, while the owning thread isn't recording.
+    [[nodiscard]] std::vector<TraceEvent> snapshot() const;
+    void clear() { head.store(0, std::memory_order_relaxed); }
+
+    const uint32_t threadId;
+
+private:
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> head{0};
+};
+
+// Converts recorded timelines for viewers. Events whose partner was overwritten or never recorded are
+// dropped or closed at the thread's last timestamp, so the output is always balanced.
+class TraceWriter {
+public:
+    // Chrome trace-event JSON, loadable in chrome://tracing or Perfetto
+    static void writeChrome(const std::vector<const TraceBuffer*>& buffers, const char* const zoneNames[],
+                            double ticksPerUs, std::ostream& out);
+    // Folded stacks ("outer;inner self_ns" per line) for flamegraph.pl and speedscope
+    static void writeFolded(const std::vector<const TraceBuffer*>& buffers, const char* const zoneNames[],
+                            double ticksPerUs, std::ostream& out);
+};
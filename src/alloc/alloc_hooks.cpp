@@ -0,0 +1,61 @@
+// Replacement global allocation functions for CHESS_ALLOC_TRACKING builds. Linked into the executables rather
+// than chess_lib so a static library can't leave them out; see CMakeLists.txt.
+#include "alloc_tracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+void* allocate(const size_t size) {
+    AllocTracker::record(size);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* allocateAligned(const size_t size, const std::align_val_t align) {
+    AllocTracker::record(size);
+    const size_t alignment = static_cast<size_t>(align);
+    // aligned_alloc wants a multiple of the alignment
+    const size_t rounded = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded);
+}
+}
+
+void* operator new(const size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](const size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(const size_t size, const std::align_val_t align) {
+    if (void* p = allocateAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](const size_t size, const std::align_val_t align) {
+    if (void* p = allocateAligned(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(const size_t size, const std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+void* operator new[](const size_t size, const std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
@@ -1,6 +1,10 @@
 #include "board/board.h"
 #include "search/zobrist.h"
+#include "eval/nnue.h"
+#include "profiler.h"
 
+#include <algorithm>
+#include <bit>
 #include <iostream>
 #include <cassert>
 #include <sstream>
@@ -27,6 +31,8 @@ void Board::init() {
     for (auto& row : board)
         for (auto& cell : row)
             cell = Piece(PieceKind::None, Color::None);
+    whiteKing = Square(-1, -1);
+    blackKing = Square(-1, -1);
 
     for (int j = 0; j < 8; j++) {
         setAt(6, j, Piece(PieceKind::Pawn, Color::White));
@@ -106,6 +112,8 @@ void Board::loadFEN(const std::string& fen) {
             setAt(r, c, Piece(PieceKind::None, Color::None));
         }
     }
+    whiteKing = Square(-1, -1);
+    blackKing = Square(-1, -1);
 
     row = 0; col = 0;
     for (char ch : piecePlacement) {
@@ -250,14 +258,102 @@ std::string Board::toUCI(const Move& move) {
     return ss.str();
 }
 
+int Board::pieceCount(const Color color, const PieceKind kind) const {
+    return counts[Zobrist::colorIndex(color)][Zobrist::pieceIndex(kind)];
+}
+
+void Board::changeCount(const int colorIdx, const int pieceIdx, const int delta) {
+    int8_t& count = counts[colorIdx][pieceIdx];
+    materialHash ^= Zobrist::material[colorIdx][pieceIdx][std::min<int>(count, Zobrist::MAX_COUNT)];
+    count = static_cast<int8_t>(count + delta);
+    materialHash ^= Zobrist::material[colorIdx][pieceIdx][std::min<int>(count, Zobrist::MAX_COUNT)];
+}
+
+void Board::changeEvalTerms(const Piece& piece, const int r, const int c, const int sign) {
+    if (accumulators.stack) {
+        accumulators.stack->change(Zobrist::pieceIndex(piece.kind), Zobrist::colorIndex(piece.color), r * 8 + c, sign);
+    }
+    const int side = piece.color == Color::White ? sign : -sign;
+    const int row = piece.color == Color::White ? r : 7 - r;
+    materialScore += side * pieceValue(piece.kind);
+
+    switch (piece.kind) {
+        case PieceKind::Knight:
+            pstEarly += side * knightPST_EARLY[row][c];
+            pstLate += side * knightPST_LATE[row][c];
+            break;
+        case PieceKind::Bishop:
+            pstEarly += side * bishopPST_EARLY[row][c];
+            pstLate += side * bishopPST_LATE[row][c];
+            break;
+        case PieceKind::Rook:
+            pstEarly += side * rookPST_EARLY[row][c];
+            pstLate += side * rookPST_LATE[row][c];
+            break;
+        case PieceKind::Queen:
+            pstEarly += side * queenPST_EARLY[row][c];
+            pstLate += side * queenPST_LATE[row][c];
+            break;
+        case PieceKind::King:
+            pstEarly += side * kingPST_EARLY[row][c];
+            pstLate += side * kingPST_LATE[row][c];
+            break;
+        default:
+            break;
+    }
+}
+
 void Board::setAt(int r, int c, Piece p) {
     board[r][c] = p;
+    if (p.kind == PieceKind::King) {
+        (p.color == Color::White ? whiteKing : blackKing) = Square(r, c);
+    }
 }
 
 void Board::setSide(Color c) {
     side = c;
 }
 
+void Board::loadPieces(const uint64_t (&pieces)[2][6], const Color toMove) {
+    constexpr PieceKind KINDS[6] = {PieceKind::Pawn, PieceKind::Knight, PieceKind::Bishop,
+                                    PieceKind::Rook, PieceKind::Queen, PieceKind::King};
+    for (auto& row : board)
+        for (auto& cell : row)
+            cell = Piece(PieceKind::None, Color::None);
+    whiteKing = Square(-1, -1);
+    blackKing = Square(-1, -1);
+
+    checkPieces(pieces);
+    for (int color = 0; color < 2; color++) {
+        for (int piece = 0; piece < 6; piece++) {
+            for (uint64_t bits = pieces[color][piece]; bits; bits &= bits - 1) {
+                const int square = __builtin_ctzll(bits);
+                setAt(square / 8, square % 8, Piece(KINDS[piece], color == 0 ? Color::White : Color::Black));
+            }
+        }
+    }
+
+    setSide(toMove);
+    whiteKingMoved = blackKingMoved = true;
+    whiteRookKingsideMoved = whiteRookQueensideMoved = true;
+    blackRookKingsideMoved = blackRookQueensideMoved = true;
+    enPassantTarget = std::nullopt;
+    computeHash();
+}
+
+void Board::checkPieces(const uint64_t (&pieces)[2][6]) {
+    constexpr uint64_t BACK_RANKS = 0xFFull | 0xFFull << 56;
+    uint64_t occupied = 0;
+    for (const auto& color : pieces) {
+        for (const uint64_t bits : color) {
+            if (occupied & bits) throw std::invalid_argument("Overlapping piece bitboards");
+            occupied |= bits;
+        }
+        if (std::popcount(color[5]) != 1) throw std::invalid_argument("Each side needs exactly one king");
+        if (color[0] & BACK_RANKS) throw std::invalid_argument("Pawn on the first or eighth rank");
+    }
+}
+
 PieceKind Board::charToKind(char c) {
     switch (c) {
         case 'p': return PieceKind::Pawn;
@@ -344,19 +440,36 @@ bool Board::validate(const Move& move) {
     return true;
 }
 
+// Recomputes every key and the piece counts from scratch; makeMove keeps them up to date afterwards
 void Board::computeHash() {
     hash = 0;
+    pawnHash = 0;
+    std::memset(counts, 0, sizeof(counts));
+    materialScore = 0;
+    pstEarly = 0;
+    pstLate = 0;
     for (int r = 0; r < 8; r++) {
         for (int c = 0; c < 8; c++) {
             Piece p = at(r, c);
             if (p.kind != PieceKind::None) {
-                hash ^= Zobrist::pieceSquare[Zobrist::colorIndex(p.color)]
-                                            [Zobrist::pieceIndex(p.kind)]
-                                            [Zobrist::squareIndex(r, c)];
+                const uint64_t key = Zobrist::pieceSquare[Zobrist::colorIndex(p.color)]
+                                                         [Zobrist::pieceIndex(p.kind)]
+                                                         [Zobrist::squareIndex(r, c)];
+                hash ^= key;
+                if (p.kind == PieceKind::Pawn) pawnHash ^= key;
+                counts[Zobrist::colorIndex(p.color)][Zobrist::pieceIndex(p.kind)]++;
+                changeEvalTerms(p, r, c, 1);
             }
         }
     }
 
+    materialHash = 0;
+    for (int color = 0; color < 2; color++) {
+        for (int piece = 0; piece < 6; piece++) {
+            materialHash ^= Zobrist::material[color][piece][std::min<int>(counts[color][piece], Zobrist::MAX_COUNT)];
+        }
+    }
+
     if (side == Color::Black) hash ^= Zobrist::sideToMove;
 
     if (!whiteKingMoved && !whiteRookKingsideMoved) hash ^= Zobrist::castling[0];
@@ -370,20 +483,8 @@ void Board::computeHash() {
 }
 
 bool Board::isChecked(const Color kingColor) const {
-    Square kingPosition = {};
-    bool found = false;
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
-            Piece piece = at(r, c);
-            if (piece.color == kingColor && piece.kind == PieceKind::King) {
-                kingPosition.r = r;
-                kingPosition.c = c;
-                found = true;
-                break;
-            }
-        }
-        if (found) break;
-    }
+    const Square kingPosition = kingSquare(kingColor);
+    if (kingPosition.r < 0) return false;
 
     Color attacker = (kingColor == Color::White) ? Color::Black : Color::White;
     if (knightAttacked(kingPosition, attacker) || pawnAttacked(kingPosition, attacker)) return true;
@@ -393,6 +494,190 @@ bool Board::isChecked(const Color kingColor) const {
     return false;
 }
 
+// Decides whether the move checks the enemy king without playing it: direct checks from the destination
+// square and discovered checks along the line the moving piece vacates.
+bool Board::givesCheck(const Move& move) const {
+    const Piece mover = at(move.current.r, move.current.c);
+    const Color enemy = (mover.color == Color::White) ? Color::Black : Color::White;
+    const Square king = kingSquare(enemy);
+    if (king.r < 0) return false;
+
+    // Castling moves the rook too and en passant vacates a second square; play those out on a scratch copy.
+    if (move.type == MoveType::Castle || move.type == MoveType::EnPassant) {
+        Board scratch = *this;
+        scratch.makeMove(move, true);
+        return scratch.isChecked(enemy);
+    }
+
+    const Square to = move.destination;
+    const int toR = king.r - to.r;
+    const int toC = king.c - to.c;
+    const PieceKind kind = (move.type == MoveType::Promotion) ? move.promotion : mover.kind;
+
+    // Direct check
+    switch (kind) {
+        case PieceKind::Pawn: {
+            const int dir = (mover.color == Color::White) ? -1 : 1;
+            if (toR == dir && std::abs(toC) == 1) return true;
+            break;
+        }
+        case PieceKind::Knight:
+            if (std::abs(toR) * std::abs(toC) == 2) return true;
+            break;
+        case PieceKind::Bishop:
+            if (std::abs(toR) == std::abs(toC) && pathClear(to, king, move.current)) return true;
+            break;
+        case PieceKind::Rook:
+            if ((toR == 0 || toC == 0) && pathClear(to, king, move.current)) return true;
+            break;
+        case PieceKind::Queen:
+            if ((toR == 0 || toC == 0 || std::abs(toR) == std::abs(toC)) &&
+                pathClear(to, king, move.current)) return true;
+            break;
+        default:
+            break;
+    }
+
+    // Discovered check: the origin square must sit on a line out of the king that the destination leaves
+    const int fromR = move.current.r - king.r;
+    const int fromC = move.current.c - king.c;
+    const bool orthogonal = (fromR == 0 || fromC == 0);
+    if (!orthogonal && std::abs(fromR) != std::abs(fromC)) return false;
+
+    const int dr = (fromR > 0) - (fromR < 0);
+    const int dc = (fromC > 0) - (fromC < 0);
+    const int destR = to.r - king.r;
+    const int destC = to.c - king.c;
+    const bool destOnRay = ((destR > 0) - (destR < 0)) == dr && ((destC > 0) - (destC < 0)) == dc &&
+                           destR * dc == destC * dr;
+    if (destOnRay || !pathClear(king, move.current, move.current)) return false;
+
+    int r = move.current.r + dr;
+    int c = move.current.c + dc;
+    while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+        const Piece p = at(r, c);
+        if (p.kind != PieceKind::None) {
+            if (p.color != mover.color) return false;
+            if (p.kind == PieceKind::Queen) return true;
+            return orthogonal ? p.kind == PieceKind::Rook : p.kind == PieceKind::Bishop;
+        }
+        r += dr;
+        c += dc;
+    }
+    return false;
+}
+
+// True when every square strictly between from and to is empty, treating vacated as already emptied.
+bool Board::pathClear(const Square from, const Square to, const Square vacated) const {
+    const int dr = (to.r > from.r) - (to.r < from.r);
+    const int dc = (to.c > from.c) - (to.c < from.c);
+    int r = from.r + dr;
+    int c = from.c + dc;
+    while (r != to.r || c != to.c) {
+        if (!(r == vacated.r && c == vacated.c) && at(r, c).kind != PieceKind::None) return false;
+        r += dr;
+        c += dc;
+    }
+    return true;
+}
+
+// Cheapest piece of attackerColor bearing on target in the scratch position; x-rays open up as pieces are lifted.
+static bool leastValuableAttacker(const Piece (&b)[8][8], const Square target, const Color attackerColor, Square& from) {
+    int best = INF;
+    auto consider = [&](const int r, const int c) {
+        const int value = pieceValue(b[r][c].kind);
+        if (value < best) {
+            best = value;
+            from = Square(r, c);
+        }
+    };
+
+    const int pawnRow = target.r + ((attackerColor == Color::White) ? 1 : -1);
+    for (int dc : {-1, 1}) {
+        const int c = target.c + dc;
+        if (pawnRow < 0 || pawnRow >= 8 || c < 0 || c >= 8) continue;
+        if (b[pawnRow][c].color == attackerColor && b[pawnRow][c].kind == PieceKind::Pawn) {
+            from = Square(pawnRow, c);
+            return true;
+        }
+    }
+
+    for (auto [dr, dc] : MovementConst::KNIGHT_LATTICE_DISPLACEMENTS) {
+        const int r = target.r + dr;
+        const int c = target.c + dc;
+        if (r < 0 || r >= 8 || c < 0 || c >= 8) continue;
+        if (b[r][c].color == attackerColor && b[r][c].kind == PieceKind::Knight) consider(r, c);
+    }
+
+    for (auto [dr, dc] : MovementConst::CHEBYSHEV_DIRECTIONS) {
+        const bool diagonal = (dr != 0 && dc != 0);
+        int r = target.r + dr;
+        int c = target.c + dc;
+        bool adjacent = true;
+        while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+            const Piece p = b[r][c];
+            if (p.kind != PieceKind::None) {
+                if (p.color == attackerColor &&
+                    (p.kind == PieceKind::Queen ||
+                     (p.kind == PieceKind::King && adjacent) ||
+                     (p.kind == PieceKind::Bishop && diagonal) ||
+                     (p.kind == PieceKind::Rook && !diagonal))) {
+                    consider(r, c);
+                }
+                break;
+            }
+            r += dr;
+            c += dc;
+            adjacent = false;
+        }
+    }
+    return best != INF;
+}
+
+// Static exchange evaluation: material the mover nets on the destination square if both sides keep
+// recapturing with their cheapest attacker and either may stop when continuing would lose.
+int Board::see(const Move& move) const {
+    PROFILE_ZONE(See);
+    Piece scratch[8][8];
+    std::memcpy(scratch, board, sizeof(board));
+
+    const Square target = move.destination;
+    const Color mover = at(move.current.r, move.current.c).color;
+    int gain[32];
+    int d = 0;
+
+    if (move.type == MoveType::EnPassant) {
+        gain[0] = pieceValue(PieceKind::Pawn);
+        scratch[move.current.r][move.destination.c] = Piece(PieceKind::None, Color::None);
+    } else {
+        gain[0] = pieceValue(scratch[target.r][target.c].kind);
+    }
+
+    int onTarget = pieceValue(scratch[move.current.r][move.current.c].kind);
+    if (move.type == MoveType::Promotion) {
+        gain[0] += pieceValue(move.promotion) - pieceValue(PieceKind::Pawn);
+        onTarget = pieceValue(move.promotion);
+    }
+    scratch[move.current.r][move.current.c] = Piece(PieceKind::None, Color::None);
+
+    Color toMove = (mover == Color::White) ? Color::Black : Color::White;
+    Square from;
+    while (d < 31 && leastValuableAttacker(scratch, target, toMove, from)) {
+        d++;
+        gain[d] = onTarget - gain[d - 1];
+        if (std::max(-gain[d - 1], gain[d]) < 0) break;  // Neither side wants to continue
+        onTarget = pieceValue(scratch[from.r][from.c].kind);
+        scratch[from.r][from.c] = Piece(PieceKind::None, Color::None);
+        toMove = (toMove == Color::White) ? Color::Black : Color::White;
+    }
+
+    while (d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        d--;
+    }
+    return gain[0];
+}
+
 bool Board::squareAttacked(const Square &square, const Color attackerColor) const {
     // Pawn Attack
     if (pawnAttacked(square, attackerColor)) return true;
@@ -498,6 +783,7 @@ std::vector<Piece> Board::pieces() const {
 }
 
 MoveUndo Board::makeMove(const Move& move, const bool hypothetical) {
+    PROFILE_ZONE(MakeMove);
     MoveUndo undo;
     Piece current_piece = at(move.current.r, move.current.c);
     Piece captured_piece = at(move.destination.r, move.destination.c);
@@ -509,6 +795,11 @@ MoveUndo Board::makeMove(const Move& move, const bool hypothetical) {
             undo.captured = at(move.destination.r, move.destination.c);
         }
         undo.prevHash = hash;
+        undo.prevPawnHash = pawnHash;
+        undo.prevMaterialHash = materialHash;
+        undo.prevMaterialScore = materialScore;
+        undo.prevPstEarly = pstEarly;
+        undo.prevPstLate = pstLate;
         undo.movedPiece = current_piece;
         undo.whiteKingMoved = whiteKingMoved;
         undo.whiteRookKingsideMoved = whiteRookKingsideMoved;
@@ -517,6 +808,7 @@ MoveUndo Board::makeMove(const Move& move, const bool hypothetical) {
         undo.blackRookKingsideMoved = blackRookKingsideMoved;
         undo.blackRookQueensideMoved = blackRookQueensideMoved;
         undo.enPassantTarget = enPassantTarget;
+        if (accumulators.stack) accumulators.stack->push();
 
         // Zobrist Hashing
         int colorIdx = Zobrist::colorIndex(current_piece.color);
@@ -526,23 +818,39 @@ MoveUndo Board::makeMove(const Move& move, const bool hypothetical) {
 
         // Remove piece from origin
         hash ^= Zobrist::pieceSquare[colorIdx][pieceIdx][fromSq];
+        changeEvalTerms(current_piece, move.current.r, move.current.c, -1);
+        const bool pawnMove = current_piece.kind == PieceKind::Pawn;
+        if (pawnMove) pawnHash ^= Zobrist::pieceSquare[colorIdx][0][fromSq];
 
         // Handle en passant capture
         if (move.type == MoveType::EnPassant) {
             int epSq = Zobrist::squareIndex(move.current.r, move.destination.c);
             hash ^= Zobrist::pieceSquare[1 - colorIdx][0][epSq];  // Remove enemy pawn
+            pawnHash ^= Zobrist::pieceSquare[1 - colorIdx][0][epSq];
+            changeCount(1 - colorIdx, 0, -1);
+            const Color enemy = current_piece.color == Color::White ? Color::Black : Color::White;
+            changeEvalTerms(Piece(PieceKind::Pawn, enemy), move.current.r, move.destination.c, -1);
         }
         else if (captured_piece.kind != PieceKind::None) {
-            hash ^= Zobrist::pieceSquare[Zobrist::colorIndex(captured_piece.color)]
-                                        [Zobrist::pieceIndex(captured_piece.kind)]
-                                        [toSq];
+            const uint64_t capturedKey = Zobrist::pieceSquare[Zobrist::colorIndex(captured_piece.color)]
+                                                             [Zobrist::pieceIndex(captured_piece.kind)]
+                                                             [toSq];
+            hash ^= capturedKey;
+            if (captured_piece.kind == PieceKind::Pawn) pawnHash ^= capturedKey;
+            changeCount(Zobrist::colorIndex(captured_piece.color), Zobrist::pieceIndex(captured_piece.kind), -1);
+            changeEvalTerms(captured_piece, move.destination.r, move.destination.c, -1);
         }
 
-        // Add piece to destination
+        // Add piece to destination; a promoting pawn leaves the pawn structure
         if (move.type == MoveType::Promotion) {
             hash ^= Zobrist::pieceSquare[colorIdx][Zobrist::pieceIndex(move.promotion)][toSq];
+            changeCount(colorIdx, 0, -1);
+            changeCount(colorIdx, Zobrist::pieceIndex(move.promotion), 1);
+            changeEvalTerms(Piece(move.promotion, current_piece.color), move.destination.r, move.destination.c, 1);
         } else {
             hash ^= Zobrist::pieceSquare[colorIdx][pieceIdx][toSq];
+            changeEvalTerms(current_piece, move.destination.r, move.destination.c, 1);
+            if (pawnMove) pawnHash ^= Zobrist::pieceSquare[colorIdx][0][toSq];
         }
 
         // Handle castling rook
@@ -554,6 +862,9 @@ MoveUndo Board::makeMove(const Move& move, const bool hypothetical) {
             int rookIdx = Zobrist::pieceIndex(PieceKind::Rook);
             hash ^= Zobrist::pieceSquare[colorIdx][rookIdx][rookFrom];
             hash ^= Zobrist::pieceSquare[colorIdx][rookIdx][rookTo];
+            const Piece rook(PieceKind::Rook, current_piece.color);
+            changeEvalTerms(rook, row, kingside ? 7 : 0, -1);
+            changeEvalTerms(rook, row, kingside ? 5 : 3, 1);
         }
         if (enPassantTarget.has_value()) {
             hash ^= Zobrist::enPassant[enPassantTarget->c]; // remove old EP
@@ -635,6 +946,7 @@ MoveUndo Board::makeMove(const Move& move, const bool hypothetical) {
 }
 
 void Board::undoMove(const MoveUndo &undo) {
+    PROFILE_ZONE(UndoMove);
     switch (undo.move.type) {
         case MoveType::EnPassant:
             // Restore moving pawn
@@ -664,7 +976,26 @@ void Board::undoMove(const MoveUndo &undo) {
             break;
     }
 
+    if (undo.movedPiece.kind == PieceKind::King) {
+        (undo.movedPiece.color == Color::White ? whiteKing : blackKing) = undo.move.current;
+    }
+
+    // Counts are reverted by hand; the keys come back from the undo record
+    const int moverIdx = Zobrist::colorIndex(undo.movedPiece.color);
+    if (undo.move.type == MoveType::Promotion) {
+        counts[moverIdx][0]++;
+        counts[moverIdx][Zobrist::pieceIndex(undo.move.promotion)]--;
+    }
+    if (undo.captured.kind != PieceKind::None) {
+        counts[Zobrist::colorIndex(undo.captured.color)][Zobrist::pieceIndex(undo.captured.kind)]++;
+    }
+
     hash = undo.prevHash;
+    pawnHash = undo.prevPawnHash;
+    materialHash = undo.prevMaterialHash;
+    materialScore = undo.prevMaterialScore;
+    pstEarly = undo.prevPstEarly;
+    pstLate = undo.prevPstLate;
     whiteKingMoved = undo.whiteKingMoved;
     whiteRookKingsideMoved = undo.whiteRookKingsideMoved;
     whiteRookQueensideMoved = undo.whiteRookQueensideMoved;
@@ -673,11 +1004,15 @@ void Board::undoMove(const MoveUndo &undo) {
     blackRookQueensideMoved = undo.blackRookQueensideMoved;
     enPassantTarget = undo.enPassantTarget;
     side = (side == Color::White) ? Color::Black : Color::White;
+    if (accumulators.stack) accumulators.stack->pop();
 }
 
 void Board::movePiece(const Square& from, const Square& to) {
     board[to.r][to.c] = board[from.r][from.c];
     board[from.r][from.c] = Piece(PieceKind::None, Color::None);
+    if (board[to.r][to.c].kind == PieceKind::King) {
+        (board[to.r][to.c].color == Color::White ? whiteKing : blackKing) = to;
+    }
 }
 
 void Board::updateCastlingRights(const Piece& piece, const Move& move) {
@@ -0,0 +1,116 @@
+#include "eval/attacks.h"
+
+#include "search/zobrist.h"
+
+#include <array>
+
+namespace {
+// Rays run from a square to the board edge, excluding the square itself
+enum Direction { North, South, East, West, NorthEast, NorthWest, SouthEast, SouthWest, DIRECTIONS };
+constexpr int DR[DIRECTIONS] = {-1, 1, 0, 0, -1, -1, 1, 1};
+constexpr int DC[DIRECTIONS] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+// Directions whose squares have increasing indices find their nearest blocker with the lowest set bit
+constexpr bool INCREASING[DIRECTIONS] = {false, true, true, false, false, false, true, true};
+
+struct Tables {
+    std::array<std::array<uint64_t, 64>, DIRECTIONS> rays{};
+    std::array<uint64_t, 64> knight{};
+    std::array<uint64_t, 64> king{};
+
+    constexpr Tables() {
+        constexpr int KNIGHT_DR[8] = {-2, -2, -1, -1, 1, 1, 2, 2};
+        constexpr int KNIGHT_DC[8] = {-1, 1, -2, 2, -2, 2, -1, 1};
+        for (int sq = 0; sq < 64; sq++) {
+            const int r = sq / 8;
+            const int c = sq % 8;
+            for (int d = 0; d < DIRECTIONS; d++) {
+                for (int nr = r + DR[d], nc = c + DC[d]; nr >= 0 && nr < 8 && nc >= 0 && nc < 8; nr += DR[d], nc += DC[d]) {
+                    rays[d][sq] |= uint64_t{1} << (nr * 8 + nc);
+                }
+                const int kr = r + DR[d];
+                const int kc = c + DC[d];
+                if (kr >= 0 && kr < 8 && kc >= 0 && kc < 8) king[sq] |= uint64_t{1} << (kr * 8 + kc);
+            }
+            for (int i = 0; i < 8; i++) {
+                const int nr = r + KNIGHT_DR[i];
+                const int nc = c + KNIGHT_DC[i];
+                if (nr >= 0 && nr < 8 && nc >= 0 && nc < 8) knight[sq] |= uint64_t{1} << (nr * 8 + nc);
+            }
+        }
+    }
+};
+
+constexpr Tables TABLES;
+
+// The ray up to and including its first blocker
+uint64_t rayAttacks(const int direction, const int square, const uint64_t occupied) {
+    const uint64_t ray = TABLES.rays[direction][square];
+    const uint64_t blockers = ray & occupied;
+    if (!blockers) return ray;
+    const int first = INCREASING[direction] ? __builtin_ctzll(blockers) : 63 - __builtin_clzll(blockers);
+    return ray ^ TABLES.rays[direction][first];
+}
+}
+
+uint64_t AttackMaps::knightAttacks(const int square) { return TABLES.knight[square]; }
+uint64_t AttackMaps::kingAttacks(const int square) { return TABLES.king[square]; }
+
+uint64_t AttackMaps::bishopAttacks(const int square, const uint64_t occupied) {
+    return rayAttacks(NorthEast, square, occupied) | rayAttacks(NorthWest, square, occupied)
+         | rayAttacks(SouthEast, square, occupied) | rayAttacks(SouthWest, square, occupied);
+}
+
+uint64_t AttackMaps::rookAttacks(const int square, const uint64_t occupied) {
+    return rayAttacks(North, square, occupied) | rayAttacks(South, square, occupied)
+         | rayAttacks(East, square, occupied) | rayAttacks(West, square, occupied);
+}
+
+AttackMaps::AttackMaps(const Board& board) {
+    for (int r = 0; r < 8; r++) {
+        for (int c = 0; c < 8; c++) {
+            const Piece p = board.at(r, c);
+            if (p.kind == PieceKind::None) continue;
+            const uint64_t b = bit(r, c);
+            occupied |= b;
+            byColor[Zobrist::colorIndex(p.color)] |= b;
+            byKind[Zobrist::colorIndex(p.color)][Zobrist::pieceIndex(p.kind)] |= b;
+        }
+    }
+
+    constexpr uint64_t NOT_A_FILE = 0xFEFEFEFEFEFEFEFEULL;
+    constexpr uint64_t NOT_H_FILE = 0x7F7F7F7F7F7F7F7FULL;
+    for (int color = 0; color < 2; color++) {
+        // White pawns attack towards row 0, black towards row 7
+        const uint64_t pawns = byKind[color][0];
+        const uint64_t west = pawns & NOT_A_FILE;
+        const uint64_t east = pawns & NOT_H_FILE;
+        pawnAttacks[color] = color == 0 ? (west >> 9) | (east >> 7) : (west << 7) | (east << 9);
+        attacks[color] = pawnAttacks[color];
+
+        auto add = [&](const uint64_t squares) {
+            attackedTwice[color] |= attacks[color] & squares;
+            attacks[color] |= squares;
+        };
+        if (byKind[color][5]) add(kingAttacks(__builtin_ctzll(byKind[color][5])));
+
+        for (int kind = 1; kind <= 4; kind++) {
+            for (uint64_t left = byKind[color][kind]; left; left &= left - 1) {
+                const int square = __builtin_ctzll(left);
+                uint64_t squares = 0;
+                PieceKind pieceKind = PieceKind::Knight;
+                switch (kind) {
+                    case 1: squares = knightAttacks(square); pieceKind = PieceKind::Knight; break;
+                    case 2: squares = bishopAttacks(square, occupied); pieceKind = PieceKind::Bishop; break;
+                    case 3: squares = rookAttacks(square, occupied); pieceKind = PieceKind::Rook; break;
+                    default:
+                        squares = bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+                        pieceKind = PieceKind::Queen;
+                        break;
+                }
+                add(squares);
+                if (pieceCount < MAX_PIECES) pieces[pieceCount++] = {squares, square, pieceKind, color};
+            }
+        }
+    }
+}
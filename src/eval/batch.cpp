@@ -0,0 +1,91 @@
+#include "eval/batch.h"
+
+#include "eval/material.h"
+#include "eval/pawn_table.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+void PositionBatch::reserve(const size_t n) {
+    for (auto& color : pieces)
+        for (auto& piece : color) piece.reserve(n);
+    toMove.reserve(n);
+}
+
+void PositionBatch::clear() {
+    for (auto& color : pieces)
+        for (auto& piece : color) piece.clear();
+    toMove.clear();
+}
+
+void PositionBatch::add(const uint64_t (&position)[2][6], const Color side) {
+    Board::checkPieces(position);
+    for (int color = 0; color < 2; color++) {
+        for (int piece = 0; piece < 6; piece++) pieces[color][piece].push_back(position[color][piece]);
+    }
+    toMove.push_back(side);
+}
+
+void PositionBatch::add(const Board& board) {
+    uint64_t position[2][6] = {};
+    for (int r = 0; r < 8; r++) {
+        for (int c = 0; c < 8; c++) {
+            const Piece p = board.at(r, c);
+            if (p.kind == PieceKind::None) continue;
+            position[Zobrist::colorIndex(p.color)][Zobrist::pieceIndex(p.kind)] |= uint64_t{1} << (r * 8 + c);
+        }
+    }
+    add(position, board.getColor());
+}
+
+void PositionBatch::load(const size_t i, Board& board) const {
+    uint64_t position[2][6];
+    for (int color = 0; color < 2; color++) {
+        for (int piece = 0; piece < 6; piece++) position[color][piece] = pieces[color][piece][i];
+    }
+    board.loadPieces(position, toMove[i]);
+}
+
+void BatchEvaluator::evaluate(const PositionBatch& batch, const std::span<int> scores, int threads) {
+    if (scores.size() != batch.size()) throw std::invalid_argument("Score span does not match the batch size");
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const size_t chunks = (batch.size() + CHUNK - 1) / CHUNK;
+    threads = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(chunks, 1)));
+
+    // Chunks are claimed dynamically so a slow chunk doesn't hold up a thread with a fixed share
+    std::atomic<size_t> next{0};
+    // The pieces are public, so a bad position can still reach loadPieces; the first error stops every worker
+    // and is rethrown here rather than escaping its thread
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto worker = [&] {
+        try {
+            Board board;
+            PawnTable pawnTable;
+            MaterialTable materialTable;
+            for (size_t chunk; (chunk = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+                const size_t end = std::min(batch.size(), (chunk + 1) * CHUNK);
+                for (size_t i = chunk * CHUNK; i < end; i++) {
+                    batch.load(i, board);
+                    scores[i] = Search::evaluate(board, &pawnTable, &materialTable);
+                }
+            }
+        } catch (...) {
+            next.store(chunks, std::memory_order_relaxed);
+            std::lock_guard lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool) thread.join();
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,98 @@
+#include "eval/endgame.h"
+
+#include "eval/kpk.h"
+#include "piece_type.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+int distance(const Square& a, const Square& b) {
+    return std::max(std::abs(a.r - b.r), std::abs(a.c - b.c));
+}
+
+// 0 in the centre, 6 in a corner
+int edgeDistance(const Square& s) {
+    return std::max(3 - s.r, s.r - 4) + std::max(3 - s.c, s.c - 4);
+}
+
+int pushToEdge(const Square& s) { return 20 * edgeDistance(s); }
+int pushClose(const Square& a, const Square& b) { return 140 - 20 * distance(a, b); }
+
+int relative(const Color strong, const int score) {
+    return strong == Color::White ? score : -score;
+}
+
+int material(const Board& board, const Color color) {
+    int total = 0;
+    for (const PieceKind kind : {PieceKind::Pawn, PieceKind::Knight, PieceKind::Bishop, PieceKind::Rook, PieceKind::Queen}) {
+        total += board.pieceCount(color, kind) * pieceValue(kind);
+    }
+    return total;
+}
+
+// First square holding the given piece, scanning from a8
+Square find(const Board& board, const Color color, const PieceKind kind) {
+    for (int r = 0; r < 8; r++) {
+        for (int c = 0; c < 8; c++) {
+            const Piece p = board.at(r, c);
+            if (p.kind == kind && p.color == color) return {r, c};
+        }
+    }
+    return {-1, -1};
+}
+
+// Square in the bitbase's orientation: a1 = 0, with the strong side's pawn moving up
+int bitbaseSquare(const Square& s, const Color strong) {
+    const int rank = strong == Color::White ? 7 - s.r : s.r;
+    return rank * 8 + s.c;
+}
+
+Color opposite(const Color color) {
+    return color == Color::White ? Color::Black : Color::White;
+}
+}
+
+int Endgame::kxk(const Board& board, const Color strong) {
+    const Square strongKing = board.kingSquare(strong);
+    const Square weakKing = board.kingSquare(opposite(strong));
+    int score = material(board, strong) + pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+
+    const bool forced = board.pieceCount(strong, PieceKind::Queen) > 0 || board.pieceCount(strong, PieceKind::Rook) > 0
+        || board.pieceCount(strong, PieceKind::Bishop) >= 2
+        || (board.pieceCount(strong, PieceKind::Bishop) > 0 && board.pieceCount(strong, PieceKind::Knight) > 0);
+    if (forced) score += KNOWN_WIN;
+    return relative(strong, score);
+}
+
+int Endgame::kbnk(const Board& board, const Color strong) {
+    const Square strongKing = board.kingSquare(strong);
+    const Square weakKing = board.kingSquare(opposite(strong));
+    const Square bishop = find(board, strong, PieceKind::Bishop);
+
+    // a1 (row 7, column 0) is dark, so dark squares have an odd row + column: dark corners are a1 and h8
+    const bool darkBishop = (bishop.r + bishop.c) % 2 == 1;
+    const Square cornerA = darkBishop ? Square(7, 0) : Square(7, 7);
+    const Square cornerB = darkBishop ? Square(0, 7) : Square(0, 0);
+    const int cornerDistance = std::min(std::abs(weakKing.r - cornerA.r) + std::abs(weakKing.c - cornerA.c),
+                                        std::abs(weakKing.r - cornerB.r) + std::abs(weakKing.c - cornerB.c));
+
+    const int score = KNOWN_WIN + pieceValue(PieceKind::Bishop) + pieceValue(PieceKind::Knight)
+        + 20 * (14 - cornerDistance) + pushClose(strongKing, weakKing);
+    return relative(strong, score);
+}
+
+int Endgame::kpk(const Board& board, const Color strong) {
+    const Square pawn = find(board, strong, PieceKind::Pawn);
+    // Only a hand-set-up board lacks a king or has a pawn on a back rank; the bitbase has no entry for either
+    if (board.kingSquare(Color::White).r < 0 || board.kingSquare(Color::Black).r < 0 || pawn.r <= 0 || pawn.r >= 7) {
+        return 0;
+    }
+    const int pawnSquare = bitbaseSquare(pawn, strong);
+    const bool win = KPK::probe(board.getColor() == strong, bitbaseSquare(board.kingSquare(strong), strong),
+                                pawnSquare, bitbaseSquare(board.kingSquare(opposite(strong)), strong));
+    if (!win) return 0;
+
+    // Prefer the advanced pawn so the search makes progress towards promotion
+    return relative(strong, KNOWN_WIN + pieceValue(PieceKind::Pawn) + 10 * (pawnSquare / 8));
+}
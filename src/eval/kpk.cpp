@@ -0,0 +1,148 @@
+#include "eval/kpk.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+// Side to move, both kings, and the pawn on files a-d, ranks 2-7
+constexpr int MAX_INDEX = 2 * 24 * 64 * 64;
+
+enum Result : uint8_t { INVALID = 0, UNKNOWN = 1, DRAW = 2, WIN = 4 };
+enum Side { STRONG = 0, WEAK = 1 };
+
+int fileOf(const int sq) { return sq & 7; }
+int rankOf(const int sq) { return sq >> 3; }
+
+int distance(const int a, const int b) {
+    return std::max(std::abs(fileOf(a) - fileOf(b)), std::abs(rankOf(a) - rankOf(b)));
+}
+
+uint64_t bit(const int sq) { return uint64_t{1} << sq; }
+
+uint64_t kingAttacks(const int sq) {
+    uint64_t attacks = 0;
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int df = -1; df <= 1; df++) {
+            const int r = rankOf(sq) + dr;
+            const int f = fileOf(sq) + df;
+            if ((dr || df) && r >= 0 && r < 8 && f >= 0 && f < 8) attacks |= bit(r * 8 + f);
+        }
+    }
+    return attacks;
+}
+
+uint64_t pawnAttacks(const int sq) {
+    uint64_t attacks = 0;
+    if (rankOf(sq) < 7) {
+        if (fileOf(sq) > 0) attacks |= bit(sq + 7);
+        if (fileOf(sq) < 7) attacks |= bit(sq + 9);
+    }
+    return attacks;
+}
+
+int index(const int side, const int weakKing, const int strongKing, const int pawn) {
+    return side | weakKing << 1 | strongKing << 7 | fileOf(pawn) << 13 | (6 - rankOf(pawn)) << 15;
+}
+
+struct Table {
+    std::array<uint8_t, MAX_INDEX> results{};
+
+    Table() {
+        for (int idx = 0; idx < MAX_INDEX; idx++) results[idx] = initial(idx);
+
+        // Resolve positions from their successors until nothing changes; whatever is left can't be won
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int idx = 0; idx < MAX_INDEX; idx++) {
+                if (results[idx] != UNKNOWN) continue;
+                results[idx] = classify(idx);
+                changed |= results[idx] != UNKNOWN;
+            }
+        }
+    }
+
+    static void decode(const int idx, int& side, int& weakKing, int& strongKing, int& pawn) {
+        side = idx & 1;
+        weakKing = (idx >> 1) & 63;
+        strongKing = (idx >> 7) & 63;
+        pawn = (6 - ((idx >> 15) & 7)) * 8 + ((idx >> 13) & 3);
+    }
+
+    static uint8_t initial(const int idx) {
+        int side, weakKing, strongKing, pawn;
+        decode(idx, side, weakKing, strongKing, pawn);
+        const int push = pawn + 8;
+
+        if (distance(weakKing, strongKing) <= 1 || strongKing == pawn || weakKing == pawn
+            || (side == STRONG && (pawnAttacks(pawn) & bit(weakKing)))) {
+            return INVALID;
+        }
+        // The pawn promotes and the new queen can't be taken
+        if (side == STRONG && rankOf(pawn) == 6 && strongKing != push && weakKing != push
+            && (distance(weakKing, push) > 1 || distance(strongKing, push) == 1)) {
+            return WIN;
+        }
+        // Stalemate, or the pawn falls
+        if (side == WEAK) {
+            const uint64_t moves = kingAttacks(weakKing) & ~kingAttacks(strongKing);
+            if (!(moves & ~pawnAttacks(pawn)) || (moves & bit(pawn))) return DRAW;
+        }
+        return UNKNOWN;
+    }
+
+    [[nodiscard]] uint8_t classify(const int idx) const {
+        int side, weakKing, strongKing, pawn;
+        decode(idx, side, weakKing, strongKing, pawn);
+        const uint8_t good = side == STRONG ? WIN : DRAW;
+        const uint8_t bad = side == STRONG ? DRAW : WIN;
+
+        // Invalid successors (kings touching, a king on the pawn, moving into check) contribute nothing
+        uint8_t r = INVALID;
+        uint64_t moves = kingAttacks(side == STRONG ? strongKing : weakKing);
+        while (moves) {
+            const int to = __builtin_ctzll(moves);
+            moves &= moves - 1;
+            r |= side == STRONG ? results[index(WEAK, weakKing, to, pawn)]
+                                : results[index(STRONG, to, strongKing, pawn)];
+        }
+
+        if (side == STRONG) {
+            if (rankOf(pawn) < 6) r |= results[index(WEAK, weakKing, strongKing, pawn + 8)];
+            if (rankOf(pawn) == 1 && pawn + 8 != strongKing && pawn + 8 != weakKing) {
+                r |= results[index(WEAK, weakKing, strongKing, pawn + 16)];
+            }
+        }
+
+        if (r & good) return good;
+        if (r & UNKNOWN) return UNKNOWN;
+        return bad;
+    }
+};
+
+const Table& table() {
+    static const Table instance;
+    return instance;
+}
+}
+
+void KPK::init() {
+    table();
+}
+
+bool KPK::probe(const bool strongToMove, int strongKing, int pawn, int weakKing) {
+    // The table only holds pawns on files a-d; mirror the rest
+    if (fileOf(pawn) > 3) {
+        strongKing ^= 7;
+        pawn ^= 7;
+        weakKing ^= 7;
+    }
+    assert(strongKing >= 0 && strongKing < 64 && weakKing >= 0 && weakKing < 64);
+    assert(rankOf(pawn) >= 1 && rankOf(pawn) <= 6);
+    const int i = index(strongToMove ? STRONG : WEAK, weakKing, strongKing, pawn);
+    assert(i >= 0 && i < MAX_INDEX);
+    return table().results[i] == WIN;
+}
@@ -0,0 +1,98 @@
+#include "eval/material.h"
+
+#include "piece_type.h"
+
+MaterialTable::MaterialTable(const size_t entries) {
+    size_t size = 1;
+    while (size * 2 <= entries) size *= 2;
+    table.resize(size);
+    mask = size - 1;
+}
+
+void MaterialTable::clear() {
+    for (auto& entry : table) entry = MaterialEntry{};
+    hits = 0;
+    misses = 0;
+}
+
+const MaterialEntry& MaterialTable::probe(const Board& board) {
+    const uint64_t key = board.getMaterialHash();
+    MaterialEntry& entry = table[key & mask];
+    if (entry.key == key) {
+        hits++;
+        return entry;
+    }
+    misses++;
+    entry = compute(board);
+    return entry;
+}
+
+namespace {
+struct Counts {
+    int pawns, knights, bishops, rooks, queens;
+
+    Counts(const Board& board, const Color color)
+        : pawns(board.pieceCount(color, PieceKind::Pawn)),
+          knights(board.pieceCount(color, PieceKind::Knight)),
+          bishops(board.pieceCount(color, PieceKind::Bishop)),
+          rooks(board.pieceCount(color, PieceKind::Rook)),
+          queens(board.pieceCount(color, PieceKind::Queen)) {}
+
+    [[nodiscard]] int minors() const { return knights + bishops; }
+    [[nodiscard]] int pieces() const { return minors() + rooks + queens; }
+    [[nodiscard]] bool bare() const { return pawns == 0 && pieces() == 0; }
+    [[nodiscard]] int nonPawnMaterial() const {
+        return knights * pieceValue(PieceKind::Knight) + bishops * pieceValue(PieceKind::Bishop)
+             + rooks * pieceValue(PieceKind::Rook) + queens * pieceValue(PieceKind::Queen);
+    }
+};
+}
+
+MaterialEntry MaterialTable::compute(const Board& board) {
+    MaterialEntry entry;
+    entry.key = board.getMaterialHash();
+    const Counts counts[2] = {Counts(board, Color::White), Counts(board, Color::Black)};
+
+    for (const Counts& side : counts) {
+        entry.phase += side.knights * PHASE_KNIGHT + side.bishops * PHASE_BISHOP
+                     + side.rooks * PHASE_ROOK + side.queens * PHASE_QUEEN;
+    }
+    entry.imbalance = BISHOP_PAIR * ((counts[0].bishops >= 2) - (counts[1].bishops >= 2));
+
+    // Bare kings, or a single minor piece between them
+    const bool noPawns = counts[0].pawns == 0 && counts[1].pawns == 0;
+    const bool noMajors = counts[0].rooks + counts[0].queens + counts[1].rooks + counts[1].queens == 0;
+    entry.deadDraw = noPawns && noMajors && counts[0].minors() + counts[1].minors() <= 1;
+    if (entry.deadDraw) return entry;
+
+    for (int us = 0; us < 2; us++) {
+        const Counts& strong = counts[us];
+        const Counts& weak = counts[1 - us];
+        const Color color = us == 0 ? Color::White : Color::Black;
+
+        if (weak.bare()) {
+            EndgameEval endgame = nullptr;
+            if (strong.pawns == 1 && strong.pieces() == 0) endgame = &Endgame::kpk;
+            else if (strong.pawns == 0 && strong.pieces() == 2 && strong.knights == 1 && strong.bishops == 1) endgame = &Endgame::kbnk;
+            else if (strong.nonPawnMaterial() >= pieceValue(PieceKind::Rook) && !(strong.pieces() == strong.knights && strong.pawns == 0)) {
+                endgame = &Endgame::kxk;
+            }
+            if (endgame) {
+                entry.endgame = endgame;
+                entry.strong = color;
+                return entry;
+            }
+        }
+
+        // Without pawns, a lead of no more than a minor piece is rarely enough to win, and two knights can't
+        // force mate even against a bare king
+        const int npm = strong.nonPawnMaterial();
+        const int weakNpm = weak.nonPawnMaterial();
+        if (strong.pawns == 0 && npm - weakNpm <= pieceValue(PieceKind::Bishop)) {
+            entry.scale[us] = npm < pieceValue(PieceKind::Rook) ? 0 : weakNpm <= pieceValue(PieceKind::Bishop) ? 4 : 14;
+        } else if (strong.pawns == 0 && strong.pieces() == strong.knights && strong.knights <= 2) {
+            entry.scale[us] = 0;
+        }
+    }
+    return entry;
+}
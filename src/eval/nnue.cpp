@@ -0,0 +1,261 @@
+#include "eval/nnue.h"
+
+#include "eval/simd.h"
+#include "search/zobrist.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CHESS_X86 1
+#endif
+
+int NnueArch::feature(const int perspective, const int kingSquare, const int piece, const int color, const int square) {
+    // Black sees the board with the ranks flipped, so both sides share one set of weights
+    const int flip = perspective == 0 ? 0 : 56;
+    const int kind = piece * 2 + (color == perspective ? 0 : 1);
+    return ((kingSquare ^ flip) * PIECE_FEATURES + kind) * 64 + (square ^ flip);
+}
+
+void NnueAccumulators::reset() {
+    top = 0;
+    stack[0].computed[0] = stack[0].computed[1] = false;
+    stack[0].kingMoved[0] = stack[0].kingMoved[1] = false;
+    stack[0].changeCount = 0;
+}
+
+void NnueAccumulators::push() {
+    assert(top + 1 < CAPACITY);
+    NnueAccumulator& next = stack[++top];
+    next.computed[0] = next.computed[1] = false;
+    next.kingMoved[0] = next.kingMoved[1] = false;
+    next.changeCount = 0;
+}
+
+void NnueAccumulators::pop() {
+    assert(top > 0);
+    top--;
+}
+
+void NnueAccumulators::change(const int piece, const int color, const int square, const int sign) {
+    NnueAccumulator& current = stack[top];
+    if (piece == Zobrist::pieceIndex(PieceKind::King)) {
+        current.kingMoved[color] = true;
+        return;
+    }
+    assert(current.changeCount < NnueAccumulator::MAX_CHANGES);
+    current.changes[current.changeCount++] = {static_cast<int8_t>(piece), static_cast<int8_t>(color),
+                                              static_cast<int8_t>(square), static_cast<int8_t>(sign)};
+}
+
+namespace {
+constexpr char MAGIC[4] = {'N', 'N', 'U', 'E'};
+constexpr int HIDDEN_INPUTS = 2 * NnueArch::L1;
+
+// The scalar versions are the reference; the compiler already vectorises them with baseline SSE2
+void scalarAccumulate(int16_t* values, const int16_t* column, const int sign) {
+    for (int i = 0; i < NnueArch::L1; i++) values[i] = static_cast<int16_t>(values[i] + sign * column[i]);
+}
+
+int32_t scalarDot(const uint8_t* input, const int8_t* weights) {
+    int32_t sum = 0;
+    for (int i = 0; i < HIDDEN_INPUTS; i++) sum += input[i] * weights[i];
+    return sum;
+}
+
+#ifdef CHESS_X86
+__attribute__((target("avx2")))
+void avx2Accumulate(int16_t* values, const int16_t* column, const int sign) {
+    for (int i = 0; i < NnueArch::L1; i += 16) {
+        const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(values + i), sign > 0 ? _mm256_add_epi16(v, w) : _mm256_sub_epi16(v, w));
+    }
+}
+
+// Inputs are at most 127, so each unsigned-by-signed pair sum fits maddubs' int16 without saturating
+__attribute__((target("avx2")))
+int32_t avx2Dot(const uint8_t* input, const int8_t* weights) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < HIDDEN_INPUTS; i += 32) {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4e));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xb1));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+void accumulate(int16_t* values, const int16_t* column, const int sign) {
+#ifdef CHESS_X86
+    if (Simd::level() == Simd::Level::Avx2) return avx2Accumulate(values, column, sign);
+#endif
+    scalarAccumulate(values, column, sign);
+}
+
+int32_t dot(const uint8_t* input, const int8_t* weights) {
+#ifdef CHESS_X86
+    if (Simd::level() == Simd::Level::Avx2) return avx2Dot(input, weights);
+#endif
+    return scalarDot(input, weights);
+}
+
+// Only a hand-set-up board lacks a king; any square gives it a consistent, if meaningless, feature set
+int kingSquare(const Board& board, const int perspective) {
+    const Square king = board.kingSquare(perspective == 0 ? Color::White : Color::Black);
+    return king.r < 0 ? 0 : king.r * 8 + king.c;
+}
+
+template<typename T>
+void readArray(std::ifstream& in, std::vector<T>& values) {
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template<typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+}
+
+NnueNetwork::NnueNetwork()
+    : ftBias(NnueArch::L1), ftWeight(static_cast<size_t>(NnueArch::INPUTS) * NnueArch::L1),
+      hiddenBias(NnueArch::L2), hiddenWeight(NnueArch::L2 * HIDDEN_INPUTS), outputWeight(NnueArch::L2) {}
+
+std::shared_ptr<const NnueNetwork> NnueNetwork::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open network file " + path);
+
+    char magic[4];
+    uint32_t header[4];
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error("Not a network file: " + path);
+    if (header[0] != NnueArch::VERSION || header[1] != NnueArch::INPUTS || header[2] != NnueArch::L1
+        || header[3] != NnueArch::L2) {
+        throw std::runtime_error("Network file has a different version or architecture: " + path);
+    }
+
+    std::shared_ptr<NnueNetwork> network(new NnueNetwork());
+    readArray(in, network->ftBias);
+    readArray(in, network->ftWeight);
+    readArray(in, network->hiddenBias);
+    readArray(in, network->hiddenWeight);
+    in.read(reinterpret_cast<char*>(&network->outputBias), sizeof(network->outputBias));
+    readArray(in, network->outputWeight);
+    if (!in || in.peek() != std::ifstream::traits_type::eof()) {
+        throw std::runtime_error("Network file has the wrong size: " + path);
+    }
+    return network;
+}
+
+std::shared_ptr<NnueNetwork> NnueNetwork::random(const uint64_t seed) {
+    std::shared_ptr<NnueNetwork> network(new NnueNetwork());
+    std::mt19937_64 rng(seed);
+    auto fill = [&rng](auto& values, const int bound) {
+        std::uniform_int_distribution<int> dist(-bound, bound);
+        for (auto& value : values) value = static_cast<std::remove_reference_t<decltype(value)>>(dist(rng));
+    };
+    fill(network->ftBias, 32);
+    fill(network->ftWeight, 8);
+    fill(network->hiddenBias, 512);
+    fill(network->hiddenWeight, 16);
+    network->outputBias = 0;
+    fill(network->outputWeight, 32);
+    return network;
+}
+
+void NnueNetwork::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    const uint32_t header[4] = {NnueArch::VERSION, NnueArch::INPUTS, NnueArch::L1, NnueArch::L2};
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    writeArray(out, ftBias);
+    writeArray(out, ftWeight);
+    writeArray(out, hiddenBias);
+    writeArray(out, hiddenWeight);
+    out.write(reinterpret_cast<const char*>(&outputBias), sizeof(outputBias));
+    writeArray(out, outputWeight);
+    if (!out) throw std::runtime_error("Cannot write network file " + path);
+}
+
+void NnueNetwork::refresh(const Board& board, const int perspective, int16_t* values) const {
+    std::copy(ftBias.begin(), ftBias.end(), values);
+    const int king = kingSquare(board, perspective);
+    for (int r = 0; r < 8; r++) {
+        for (int c = 0; c < 8; c++) {
+            const Piece p = board.at(r, c);
+            if (p.kind == PieceKind::None || p.kind == PieceKind::King) continue;
+            const int index = NnueArch::feature(perspective, king, Zobrist::pieceIndex(p.kind),
+                                                Zobrist::colorIndex(p.color), r * 8 + c);
+            accumulate(values, &ftWeight[static_cast<size_t>(index) * NnueArch::L1], 1);
+        }
+    }
+}
+
+// Finds the nearest ply whose sums are known and replays the piece changes since; a king move on the way means
+// every feature of that side changed, so the current ply is rebuilt from the board instead
+void NnueNetwork::update(const Board& board, NnueAccumulators& accumulators, const int perspective) const {
+    std::vector<NnueAccumulator>& stack = accumulators.stack;
+    const int top = accumulators.top;
+    int known = top;
+    while (!stack[known].computed[perspective]) {
+        if (stack[known].kingMoved[perspective] || known == 0) {
+            refresh(board, perspective, stack[top].values[perspective]);
+            stack[top].computed[perspective] = true;
+            return;
+        }
+        known--;
+    }
+
+    const int king = kingSquare(board, perspective);
+    for (int ply = known + 1; ply <= top; ply++) {
+        NnueAccumulator& current = stack[ply];
+        std::copy(std::begin(stack[ply - 1].values[perspective]), std::end(stack[ply - 1].values[perspective]),
+                  current.values[perspective]);
+        for (int i = 0; i < current.changeCount; i++) {
+            const NnueAccumulator::Change& change = current.changes[i];
+            const int index = NnueArch::feature(perspective, king, change.piece, change.color, change.square);
+            accumulate(current.values[perspective], &ftWeight[static_cast<size_t>(index) * NnueArch::L1], change.sign);
+        }
+        current.computed[perspective] = true;
+    }
+}
+
+int NnueNetwork::propagate(const Board& board, const int16_t (&values)[2][NnueArch::L1]) const {
+    const int us = Zobrist::colorIndex(board.getColor());
+    alignas(32) uint8_t input[HIDDEN_INPUTS];
+    for (int i = 0; i < NnueArch::L1; i++) {
+        input[i] = static_cast<uint8_t>(std::clamp<int>(values[us][i], 0, NnueArch::CLIP));
+        input[NnueArch::L1 + i] = static_cast<uint8_t>(std::clamp<int>(values[1 - us][i], 0, NnueArch::CLIP));
+    }
+
+    int32_t output = outputBias;
+    for (int j = 0; j < NnueArch::L2; j++) {
+        const int32_t sum = hiddenBias[j] + dot(input, &hiddenWeight[static_cast<size_t>(j) * HIDDEN_INPUTS]);
+        output += std::clamp(sum >> NnueArch::HIDDEN_SHIFT, 0, NnueArch::CLIP) * outputWeight[j];
+    }
+    const int score = output / NnueArch::OUTPUT_DIVISOR;
+    return us == 0 ? score : -score;
+}
+
+int NnueNetwork::evaluate(const Board& board, NnueAccumulators& accumulators) const {
+    update(board, accumulators, 0);
+    update(board, accumulators, 1);
+    return propagate(board, accumulators.stack[accumulators.top].values);
+}
+
+int NnueNetwork::evaluate(const Board& board) const {
+    alignas(32) int16_t values[2][NnueArch::L1];
+    refresh(board, 0, values[0]);
+    refresh(board, 1, values[1]);
+    return propagate(board, values);
+}
@@ -0,0 +1,81 @@
+#include "eval/pawn_table.h"
+
+#include "piece_type.h"
+#include "search/zobrist.h"
+
+PawnTable::PawnTable(const size_t entries) {
+    size_t size = 1;
+    while (size * 2 <= entries) size *= 2;
+    table.resize(size);
+    mask = size - 1;
+}
+
+void PawnTable::clear() {
+    for (auto& entry : table) entry = PawnEntry{};
+    hits = 0;
+    misses = 0;
+}
+
+const PawnEntry& PawnTable::probe(const Board& board) {
+    const uint64_t key = board.getPawnHash();
+    PawnEntry& entry = table[key & mask];
+    if (entry.key == key) {
+        hits++;
+        return entry;
+    }
+    misses++;
+    entry = compute(board);
+    return entry;
+}
+
+PawnEntry PawnTable::compute(const Board& board) {
+    PawnEntry entry;
+    entry.key = board.getPawnHash();
+
+    auto pawnAt = [&](const int r, const int c, const Color color) {
+        const Piece p = board.at(r, c);
+        return p.kind == PieceKind::Pawn && p.color == color;
+    };
+
+    auto enemyPawnAheadOnFile = [&](const int r, const int file, const int dr, const Color color) {
+        return board.rayScan(r, file, dr, 0,
+            [&](const Piece& p) {
+                return p.kind == PieceKind::Pawn && p.color != color;
+            }
+        );
+    };
+
+    for (int r = 0; r < 8; r++) {
+        for (int c = 0; c < 8; c++) {
+            const auto [kind, color] = board.at(r, c);
+            if (kind != PieceKind::Pawn) continue;
+
+            const int sign = (color == Color::White) ? 1 : -1;
+            const int pstRow = (color == Color::White) ? r : 7 - r;
+            const int dr = (color == Color::White) ? -1 : 1;
+
+            int pawnScore = pawnPST[pstRow][c];
+            const bool sameFile = enemyPawnAheadOnFile(r, c, dr, color);
+            const bool leftFile = c > 0 && enemyPawnAheadOnFile(r, c - 1, dr, color);
+            const bool rightFile = c < 7 && enemyPawnAheadOnFile(r, c + 1, dr, color);
+
+            if (!sameFile && !leftFile && !rightFile) {
+                const int rankBonus = (color == Color::White) ? (7 - r) : r;  // 0-6, higher = more advanced
+                pawnScore += 10 + rankBonus * 15;  // 10 to 100 based on rank
+            }
+            entry.score += pawnScore * sign;
+        }
+    }
+
+    // Kingside: f, g and one of h2/h3 (h7/h6). Queenside: a, b and c pawns on the second rank.
+    for (const Color color : {Color::White, Color::Black}) {
+        const int home = (color == Color::White) ? 6 : 1;
+        const int third = (color == Color::White) ? 5 : 2;
+        const int side = Zobrist::colorIndex(color);
+        entry.shield[side][PawnEntry::Kingside] = static_cast<uint8_t>(
+            pawnAt(home, 5, color) + pawnAt(home, 6, color) + (pawnAt(home, 7, color) ^ pawnAt(third, 7, color)));
+        entry.shield[side][PawnEntry::Queenside] = static_cast<uint8_t>(
+            pawnAt(home, 0, color) + pawnAt(home, 1, color) + pawnAt(home, 2, color));
+    }
+    return entry;
+}
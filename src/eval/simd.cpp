@@ -0,0 +1,101 @@
+#include "eval/simd.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CHESS_X86 1
+#endif
+
+namespace {
+using Kernel = int (*)(const uint64_t*, const int16_t*, int);
+
+// Without -mpopcnt this is a bit-twiddling popcount; it is the reference the vector versions must match
+int scalarWeightedPopcount(const uint64_t* bits, const int16_t* weights, const int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) sum += std::popcount(bits[i]) * weights[i];
+    return sum;
+}
+
+#ifdef CHESS_X86
+__attribute__((target("sse4.2,popcnt")))
+int sse42WeightedPopcount(const uint64_t* bits, const int16_t* weights, const int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) sum += static_cast<int>(_mm_popcnt_u64(bits[i])) * weights[i];
+    return sum;
+}
+
+// Four words per step: nibble lookups count each byte, vpsadbw adds the bytes of each word, and the signed
+// 32-bit multiply applies the weights
+__attribute__((target("avx2,popcnt")))
+int avx2WeightedPopcount(const uint64_t* bits, const int16_t* weights, const int n) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i));
+        const __m256i nibbles = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low)),
+                                                _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+        const __m256i counts = _mm256_sad_epu8(nibbles, _mm256_setzero_si256());
+        const __m256i w = _mm256_cvtepi16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(weights + i)));
+        total = _mm256_add_epi64(total, _mm256_mul_epi32(counts, w));
+    }
+    const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    int sum = static_cast<int>(_mm_cvtsi128_si64(half) + _mm_extract_epi64(half, 1));
+    for (; i < n; i++) sum += static_cast<int>(_mm_popcnt_u64(bits[i])) * weights[i];
+    return sum;
+}
+#endif
+
+Kernel kernelFor(const Simd::Level level) {
+#ifdef CHESS_X86
+    switch (level) {
+        case Simd::Level::Avx2: return avx2WeightedPopcount;
+        case Simd::Level::Sse42: return sse42WeightedPopcount;
+        default: break;
+    }
+#endif
+    static_cast<void>(level);
+    return scalarWeightedPopcount;
+}
+
+std::atomic<Simd::Level> current{Simd::detect()};
+std::atomic<Kernel> weightedPopcountKernel{kernelFor(current.load())};
+}
+
+Simd::Level Simd::detect() {
+#ifdef CHESS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return Level::Avx2;
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) return Level::Sse42;
+#endif
+    return Level::Scalar;
+}
+
+Simd::Level Simd::level() { return current.load(std::memory_order_relaxed); }
+
+Simd::Level Simd::setLevel(const Level requested) {
+    const Level level = std::min(requested, detect());
+    current.store(level, std::memory_order_relaxed);
+    weightedPopcountKernel.store(kernelFor(level), std::memory_order_relaxed);
+    return level;
+}
+
+const char* Simd::name(const Level level) {
+    switch (level) {
+        case Level::Avx2: return "avx2";
+        case Level::Sse42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+int Simd::weightedPopcount(const uint64_t* bits, const int16_t* weights, const int n) {
+    return weightedPopcountKernel.load(std::memory_order_relaxed)(bits, weights, n);
+}
+
+int Simd::weightedPopcount(const Level level, const uint64_t* bits, const int16_t* weights, const int n) {
+    return kernelFor(level)(bits, weights, n);
+}
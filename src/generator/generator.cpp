@@ -1,22 +1,33 @@
 #include "generator/generator.h"
 #include "pieces.h"
 #include "dispatch/piece_dispatch.h"
+#include "profiler.h"
 
 std::vector<Move> Generator::generatePseudoMoves(Board& board) {
     std::vector<Move> moves;
-    Color side = board.getColor();
+    if (board.getColor() == Color::White) generatePseudoMoves<Color::White>(board, moves);
+    else generatePseudoMoves<Color::Black>(board, moves);
+    return moves;
+}
+
+template<Color Side>
+void Generator::generatePseudoMoves(Board& board, std::vector<Move>& moves) {
+    PROFILE_ZONE(GenerateMoves);
 
     for (int r = 0; r < 8; ++r) {
         for (int c = 0; c < 8; ++c) {
-            Piece p = board.at(r, c);
-            if (p.color == side) {
-                dispatchPiece(p.kind).generateMoves(board, r, c, moves);
-            }
+            const Piece p = board.at(r, c);
+            if (p.color != Side) continue;
+            // Pawns are the only piece whose moves depend on colour, so they skip the virtual call
+            if (p.kind == PieceKind::Pawn) Pawn::generate<Side>(board, r, c, moves);
+            else dispatchPiece(p.kind).generateMoves(board, r, c, moves);
         }
     }
-    return moves;
 }
 
+template void Generator::generatePseudoMoves<Color::White>(Board& board, std::vector<Move>& moves);
+template void Generator::generatePseudoMoves<Color::Black>(Board& board, std::vector<Move>& moves);
+
 void Generator::generateSlidingCaptures(const Board& board, int r, int c,
                                          std::vector<Move>& captures, Color enemy,
                                          bool diagonal, bool orthogonal) {
@@ -46,18 +57,26 @@ void Generator::generateSlidingCaptures(const Board& board, int r, int c,
 std::vector<Move> Generator::generateCaptures(const Board& board) {
     std::vector<Move> captures;
     captures.reserve(32);
+    if (board.getColor() == Color::White) generateCaptures<Color::White>(board, captures);
+    else generateCaptures<Color::Black>(board, captures);
+    return captures;
+}
+
+template<Color Side>
+void Generator::generateCaptures(const Board& board, std::vector<Move>& captures) {
+    PROFILE_ZONE(GenerateCaptures);
 
-    const Color side = board.getColor();
-    const Color enemy = (side == Color::White) ? Color::Black : Color::White;
+    constexpr Color enemy = (Side == Color::White) ? Color::Black : Color::White;
+    constexpr int dir = (Side == Color::White) ? -1 : 1;
+    constexpr int promotionRow = (Side == Color::White) ? 0 : 7;
 
     for (int r = 0; r < 8; r++) {
         for (int c = 0; c < 8; c++) {
             const Piece piece = board.at(r, c);
-            if (piece.color != side) continue;
+            if (piece.color != Side) continue;
 
             switch (piece.kind) {
                 case PieceKind::Pawn: {
-                    int dir = (side == Color::White) ? -1 : 1;
                     // Pawn captures only (diagonal)
                     for (int dc : {-1, 1}) {
                         int nr = r + dir;
@@ -66,13 +85,18 @@ std::vector<Move> Generator::generateCaptures(const Board& board) {
                         Piece target = board.at(nr, nc);
                         if (target.color == enemy) {
                             // Check for promotion
-                            if (nr == 0 || nr == 7) {
+                            if (nr == promotionRow) {
                                 captures.push_back(Move({r, c}, {nr, nc}, MoveType::Promotion, PieceKind::Queen));
                             } else {
                                 captures.push_back(Move({r, c}, {nr, nc}));
                             }
                         }
                     }
+                    // Quiet queen promotion
+                    const int pushRow = r + dir;
+                    if (pushRow == promotionRow && board.at(pushRow, c).kind == PieceKind::None) {
+                        captures.push_back(Move({r, c}, {pushRow, c}, MoveType::Promotion, PieceKind::Queen));
+                    }
                     // En passant
                     if (board.enPassantTarget.has_value()) {
                         auto ep = board.enPassantTarget.value();
@@ -125,6 +149,7 @@ std::vector<Move> Generator::generateCaptures(const Board& board) {
             }
         }
     }
-
-    return captures;
 }
+
+template void Generator::generateCaptures<Color::White>(const Board& board, std::vector<Move>& captures);
+template void Generator::generateCaptures<Color::Black>(const Board& board, std::vector<Move>& captures);
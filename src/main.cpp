@@ -1,14 +1,81 @@
 #include <iostream>
 #include <sstream>
-#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
 #include "board/board.h"
 #include "search/search.h"
 #include "search/zobrist.h"
+#include "eval/kpk.h"
+#include "eval/nnue.h"
+#include "bench/bench.h"
 #include "profiler.h"
+#include "alloc_tracker.h"
+
+// bench [depth] [threads] [hash] [perf] [trace] [stats] [noalloc]
+// Returns false when noalloc was given and the search tree allocated
+bool runBench(std::istream& args) {
+    int depth = Bench::DEFAULT_DEPTH;
+    int threads = Bench::DEFAULT_THREADS;
+    size_t hashMb = Bench::DEFAULT_HASH_MB;
+    bool collectPerf = false;
+    bool collectTrace = false;
+    bool printStats = false;
+    bool requireNoAlloc = false;
+
+    // Numbers fill depth, threads and hash in order; the keywords may appear anywhere
+    std::string token;
+    int position = 0;
+    while (args >> token) {
+        if (token == "perf") collectPerf = true;
+        else if (token == "trace") collectTrace = true;
+        else if (token == "stats") printStats = true;
+        else if (token == "noalloc") requireNoAlloc = true;
+        else if (position == 0) depth = std::stoi(token), position++;
+        else if (position == 1) threads = std::stoi(token), position++;
+        else if (position == 2) hashMb = std::stoul(token), position++;
+    }
+    if constexpr (Profiler::ENABLED) {
+        Profiler::enablePerf(collectPerf);
+        Profiler::enableTrace(collectTrace);
+        Profiler::reset();
+    }
+    const BenchResult result = Bench::run(std::max(depth, 1), std::max(threads, 1), std::max<size_t>(hashMb, 1),
+                                          std::cout, collectPerf);
+    if (printStats) result.stats.print(std::cout);
+    if constexpr (Profiler::ENABLED) {
+        Profiler::print();
+        if (collectTrace) {
+            std::ofstream chrome("bench_trace.json");
+            std::ofstream folded("bench_trace.folded");
+            Profiler::writeTrace(chrome, folded);
+            Profiler::enableTrace(false);
+            std::cout << "Trace written to bench_trace.json and bench_trace.folded\n";
+        }
+    } else if (collectTrace) {
+        std::cout << "Tracing needs a build configured with -DCHESS_PROFILE=ON\n";
+    }
+
+    if (!requireNoAlloc) return true;
+    if constexpr (!AllocTracker::ENABLED) {
+        std::cout << "noalloc needs a build configured with -DCHESS_ALLOC_TRACKING=ON\n";
+        return true;
+    }
+    const AllocCounts& tree = result.stats.allocs.tree;
+    if (tree.allocations > 0) {
+        std::cout << "noalloc FAILED: search tree made " << tree.allocations << " allocations (" << tree.bytes
+                  << " bytes)\n";
+        return false;
+    }
+    std::cout << "noalloc OK: search tree made no allocations\n";
+    return true;
+}
 
 void uciLoop() {
     Board board;
     Search search;
+    bool searchStats = false;
+    bool searchTrace = false;
     std::string line;
 
     while (std::getline(std::cin, line)) {
@@ -19,11 +86,55 @@ void uciLoop() {
         if (cmd == "uci") {
             std::cout << "id name Viktoriya Ivanovna Serebryakova\n";
             std::cout << "id author Michael Li\n";
+            std::cout << "option name Hash type spin default 64 min 1 max 4096\n";
+            std::cout << "option name MultiPV type spin default 1 min 1 max " << Search::MAX_MULTI_PV << "\n";
+            std::cout << "option name SearchStats type check default false\n";
+            std::cout << "option name Trace type check default false\n";
+            std::cout << "option name EvalFile type string default <empty>\n";
+            std::cout << "option name UseNNUE type check default false\n";
             std::cout << "uciok\n";
         }
         else if (cmd == "isready") {
             std::cout << "readyok\n";
         }
+        else if (cmd == "setoption") {
+            // setoption name <id> [value <x>]; option names may contain spaces
+            std::string token, name, value;
+            ss >> token;
+            while (ss >> token && token != "value") {
+                name += (name.empty() ? "" : " ") + token;
+            }
+            std::getline(ss >> std::ws, value);  // The rest of the line, so file paths may contain spaces
+
+            if ((name == "MultiPV" || name == "Hash") && !value.empty()) {
+                // A value that isn't a number leaves the option as it was
+                try {
+                    if (name == "MultiPV") search.setMultiPV(std::stoi(value));
+                    else search.resizeTT(std::clamp(std::stoi(value), 1, 4096));
+                } catch (const std::invalid_argument&) {
+                    std::cout << "info string " << name << " needs a number, got " << value << "\n";
+                } catch (const std::out_of_range&) {
+                    std::cout << "info string " << name << " value out of range: " << value << "\n";
+                }
+            } else if (name == "SearchStats") {
+                searchStats = value == "true";
+            } else if (name == "Trace") {
+                searchTrace = value == "true";
+                if (searchTrace && !Profiler::ENABLED) {
+                    std::cout << "info string Tracing needs a build configured with -DCHESS_PROFILE=ON\n";
+                }
+            } else if (name == "EvalFile") {
+                // A bad file leaves the previous network, if any, in place
+                try {
+                    search.setNetwork(value.empty() || value == "<empty>" ? nullptr : NnueNetwork::load(value));
+                } catch (const std::runtime_error& e) {
+                    std::cout << "info string " << e.what() << "\n";
+                }
+            } else if (name == "UseNNUE") {
+                search.setUseNnue(value == "true");
+                if (value == "true" && !search.nnueActive()) std::cout << "info string UseNNUE needs an EvalFile\n";
+            }
+        }
         else if (cmd == "ucinewgame") {
             board = Board();
             search.clearTT();
@@ -50,38 +161,50 @@ void uciLoop() {
             }
         }
         else if (cmd == "go") {
-            int depth = 5;
+            SearchLimits limits;
             std::string token;
             while (ss >> token) {
-                if (token == "depth") ss >> depth;
+                if (token == "depth") ss >> limits.depth;
+                else if (token == "movetime") ss >> limits.movetime;
+                else if (token == "wtime") ss >> limits.wtime;
+                else if (token == "btime") ss >> limits.btime;
+                else if (token == "winc") ss >> limits.winc;
+                else if (token == "binc") ss >> limits.binc;
+                else if (token == "movestogo") ss >> limits.movestogo;
+                else if (token == "nodes") ss >> limits.nodes;
+            }
+            if (limits.depth == 0 && limits.movetime == 0 && limits.wtime == 0 && limits.btime == 0 && limits.nodes == 0) {
+                limits.depth = 5;
             }
 
-            Move best = search.findBestMove(board, depth);
+            if constexpr (Profiler::ENABLED) {
+                if (searchTrace) {
+                    Profiler::enableTrace(true);
+                    Profiler::reset();
+                }
+            }
+            Move best = search.findBestMove(board, limits);
+            if constexpr (Profiler::ENABLED) {
+                if (searchTrace) {
+                    // Each search overwrites the last one's trace
+                    std::ofstream chrome("search_trace.json");
+                    std::ofstream folded("search_trace.folded");
+                    Profiler::writeTrace(chrome, folded);
+                    Profiler::enableTrace(false);
+                    std::cout << "info string Trace written to search_trace.json and search_trace.folded\n";
+                }
+            }
+            if (searchStats) {
+                // As info strings so a GUI passes them through instead of choking on them
+                std::ostringstream stats;
+                search.getStats().print(stats);
+                std::istringstream rows(stats.str());
+                for (std::string row; std::getline(rows, row);) std::cout << "info string " << row << "\n";
+            }
             std::cout << "bestmove " << Board::toUCI(best) << "\n";
         }
         else if (cmd == "bench") {
-            Board benchBoard;
-            search.clearTT();
-            search.resetTTStats();
-
-            for (int depth = 1; depth <= 7; depth++) {
-
-                auto depthStart = std::chrono::high_resolution_clock::now();
-                Profiler::reset();
-                Move best = search.findBestMove(benchBoard, depth);
-                Profiler::print();
-                auto depthEnd = std::chrono::high_resolution_clock::now();
-                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(depthEnd - depthStart).count();
-
-                auto [hits, misses, stores] = search.getTTStats();
-                double hitRate = (hits + misses) > 0 ? (100.0 * hits / (hits + misses)) : 0;
-
-                std::cout << "Depth " << depth << ": " << ms << "ms"
-                          << ", best=" << Board::toUCI(best)
-                          << ", TT hits=" << hits << " misses=" << misses
-                          << " (" << hitRate << "%)"
-                          << ", stores=" << stores << "\n";
-            }
+            runBench(ss);
         }
         else if (cmd == "quit") {
             break;
@@ -91,8 +214,17 @@ void uciLoop() {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     Zobrist::init();
+    KPK::init();
+
+    // `chess bench [depth] [threads] [hash]` runs the bench and exits, for scripts and CI; noalloc failures exit 1
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        std::stringstream args;
+        for (int i = 2; i < argc; i++) args << argv[i] << " ";
+        return runBench(args) ? 0 : 1;
+    }
+
     uciLoop();
     return 0;
 }
\ No newline at end of file
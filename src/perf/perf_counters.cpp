@@ -0,0 +1,93 @@
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef __linux__
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cacheMiss(const uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Indexed by PerfEvent
+constexpr EventConfig EVENT_CONFIGS[PerfCounters::EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+int openEvent(const EventConfig& event) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread, any CPU, no group
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+}
+
+PerfCounters::PerfCounters() {
+    fds.fill(-1);
+#ifdef __linux__
+    for (size_t i = 0; i < EVENTS; i++) fds[i] = openEvent(EVENT_CONFIGS[i]);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (const int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (const int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+PerfCounters::Values PerfCounters::read() const {
+    Values values{};
+#ifdef __linux__
+    for (size_t i = 0; i < EVENTS; i++) {
+        if (fds[i] < 0) continue;
+        uint64_t buffer[3] = {};  // value, time enabled, time running
+        if (::read(fds[i], buffer, sizeof(buffer)) != sizeof(buffer) || buffer[2] == 0) continue;
+        values[i] = buffer[1] == buffer[2]
+            ? buffer[0]
+            : static_cast<uint64_t>(static_cast<double>(buffer[0]) * static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]));
+    }
+#endif
+    return values;
+}
+
+void PerfCounters::print(const Values& values, std::ostream& out) {
+    const auto cycles = values[static_cast<size_t>(PerfEvent::Cycles)];
+    const auto instructions = values[static_cast<size_t>(PerfEvent::Instructions)];
+    const char* separator = "";
+    for (size_t i = 0; i < EVENTS; i++) {
+        if (values[i] == 0) continue;
+        out << separator << NAMES[i] << "=" << values[i];
+        separator = " ";
+    }
+    if (cycles > 0) {
+        out << separator << "IPC=" << static_cast<double>(instructions) / static_cast<double>(cycles);
+    }
+}
@@ -0,0 +1,102 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+
+std::vector<TraceEvent> TraceBuffer::snapshot() const {
+    const uint64_t end = head.load(std::memory_order_acquire);
+    const uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    std::vector<TraceEvent> result;
+    result.reserve(end - begin);
+    for (uint64_t i = begin; i < end; i++) result.push_back(events[i & (CAPACITY - 1)]);
+    return result;
+}
+
+namespace {
+// Walks one thread's events as properly nested spans. An end with no begin (its begin was overwritten) is
+// skipped; begins still open at the end are closed at the last timestamp.
+template <typename OnBegin, typename OnEnd>
+void walkSpans(const std::vector<TraceEvent>& events, OnBegin onBegin, OnEnd onEnd) {
+    std::vector<uint8_t> open;
+    for (const TraceEvent& event : events) {
+        if (event.begin) {
+            open.push_back(event.zone);
+            onBegin(event.zone, event.ticks, open);
+        } else if (!open.empty()) {
+            onEnd(event.ticks, open);
+            open.pop_back();
+        }
+    }
+    const uint64_t last = events.empty() ? 0 : events.back().ticks;
+    while (!open.empty()) {
+        onEnd(last, open);
+        open.pop_back();
+    }
+}
+
+uint64_t originTicks(const std::vector<std::vector<TraceEvent>>& timelines) {
+    uint64_t origin = std::numeric_limits<uint64_t>::max();
+    for (const auto& events : timelines) {
+        if (!events.empty()) origin = std::min(origin, events.front().ticks);
+    }
+    return origin == std::numeric_limits<uint64_t>::max() ? 0 : origin;
+}
+}
+
+void TraceWriter::writeChrome(const std::vector<const TraceBuffer*>& buffers, const char* const zoneNames[],
+                              const double ticksPerUs, std::ostream& out) {
+    std::vector<std::vector<TraceEvent>> timelines;
+    for (const TraceBuffer* buffer : buffers) timelines.push_back(buffer->snapshot());
+    const uint64_t origin = originTicks(timelines);
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    auto emit = [&](const char* phase, const uint8_t zone, const uint64_t ticks, const uint32_t tid) {
+        out << (first ? "\n" : ",\n") << "{\"name\":\"" << zoneNames[zone] << "\",\"ph\":\"" << phase
+            << "\",\"ts\":" << static_cast<double>(ticks - origin) / ticksPerUs << ",\"pid\":1,\"tid\":" << tid << "}";
+        first = false;
+    };
+
+    for (size_t t = 0; t < buffers.size(); t++) {
+        const uint32_t tid = buffers[t]->threadId;
+        walkSpans(timelines[t],
+            [&](const uint8_t zone, const uint64_t ticks, const std::vector<uint8_t>&) { emit("B", zone, ticks, tid); },
+            [&](const uint64_t ticks, const std::vector<uint8_t>& open) { emit("E", open.back(), ticks, tid); });
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void TraceWriter::writeFolded(const std::vector<const TraceBuffer*>& buffers, const char* const zoneNames[],
+                              const double ticksPerUs, std::ostream& out) {
+    // Self time per distinct stack, merged across threads
+    std::map<std::string, uint64_t> selfTicks;
+
+    for (const TraceBuffer* buffer : buffers) {
+        struct Frame {
+            uint64_t start;
+            uint64_t childTicks;
+        };
+        std::vector<Frame> frames;
+        walkSpans(buffer->snapshot(),
+            [&](uint8_t, const uint64_t ticks, const std::vector<uint8_t>&) { frames.push_back({ticks, 0}); },
+            [&](const uint64_t ticks, const std::vector<uint8_t>& open) {
+                const Frame frame = frames.back();
+                frames.pop_back();
+                const uint64_t elapsed = ticks > frame.start ? ticks - frame.start : 0;
+
+                std::string stack;
+                for (const uint8_t zone : open) {
+                    if (!stack.empty()) stack += ';';
+                    stack += zoneNames[zone];
+                }
+                selfTicks[stack] += elapsed > frame.childTicks ? elapsed - frame.childTicks : 0;
+                if (!frames.empty()) frames.back().childTicks += elapsed;
+            });
+    }
+
+    for (const auto& [stack, ticks] : selfTicks) {
+        out << stack << " " << static_cast<uint64_t>(static_cast<double>(ticks) * 1000.0 / ticksPerUs) << "\n";
+    }
+}
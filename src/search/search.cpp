@@ -5,246 +5,641 @@
 #include "generator/generator.h"
 #include "piece_type.h"
 #include "board/transposition.h"
+#include "search/zobrist.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
+#include "eval/attacks.h"
+#include "eval/simd.h"
 
 #include <vector>
 #include <algorithm>
+#include <bit>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <ranges>
+#include <utility>
+
+namespace {
+template<Color C>
+constexpr Color opponent = (C == Color::White) ? Color::Black : Color::White;
+
+// The search passes windows from White's point of view; this turns a side-relative one back
+template<Color Us>
+constexpr std::pair<int, int> whiteWindow(const int usAlpha, const int usBeta) {
+    if constexpr (Us == Color::White) return {usAlpha, usBeta};
+    else return {-usBeta, -usAlpha};
+}
+}
 
 
 Move Search::findBestMove(Board& board, const int depth) {
-    int alpha = -INF;
-    int beta = INF;
-    rootDepth = depth;
-    const std::vector<Move> moves = Generator::generatePseudoMoves(board);
+    SearchLimits limits;
+    limits.depth = depth;
+    return findBestMove(board, limits);
+}
+
+void Search::setNetwork(std::shared_ptr<const NnueNetwork> net) {
+    network = std::move(net);
+    if (network && !accumulators) accumulators = std::make_unique<NnueAccumulators>();
+    // Stored scores and bounds came from the old evaluation
+    evalCache.clear();
+    tt.clear();
+}
+
+void Search::setUseNnue(const bool enabled) {
+    if (enabled == useNnue) return;
+    useNnue = enabled;
+    evalCache.clear();
+    tt.clear();
+}
+
+Move Search::findBestMove(Board& board, const SearchLimits& limits) {
+    // The board keeps the accumulators in step with every move the search makes, until it returns
+    struct AccumulatorGuard {
+        Board& board;
+        ~AccumulatorGuard() { board.attachAccumulators(nullptr); }
+    } accumulatorGuard{board};
+    if (nnueActive()) {
+        accumulators->reset();
+        board.attachAccumulators(accumulators.get());
+    }
+
+    searchStart = std::chrono::steady_clock::now();
+    nodes = 0;
+    selDepth = 0;
+    stopped = false;
+    nodeLimit = limits.nodes;
+    stats.clear();
+    iterationStats = &scratchStats;
+    allocateTime(limits, board.getColor());
     const double phase = computePhase(board) / static_cast<double>(MAX_PHASE);
     updatePST(phase);
-    bool foundLegal = false;
 
-    Move bestMove;
+    AllocCounts allocsBefore = AllocTracker::counts();
+    initRootMoves(board);
+    stats.allocs.setup += AllocTracker::counts() - allocsBefore;
+    if (rootMoves.empty()) return Move{};
+
+    const int maxDepth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+    const size_t lines = std::min<size_t>(multiPV, rootMoves.size());
+    int64_t lastInfo = -INFO_INTERVAL_MS;
+    int completedDepth = 0;
+    int printedDepth = 0;
+    double bestMoveChanges = 0;
+
+    // Iterative deepening: each pass seeds the TT and reorders the root list for the next, deeper one
+    for (int d = 1; d <= maxDepth; d++) {
+        rootDepth = d;
+        stats.depths.emplace_back();
+        iterationStats = &stats.depths.back();
+        const Move previousBest = rootMoves[0].move;
+        completedRootMoves = rootMoves;  // Assigning over the last snapshot reuses its buffers
+
+        // Multi-PV: slot i searches the moves from i onwards, so earlier lines' moves are excluded.
+        // The slots share the TT, so later ones mostly re-walk subtrees the first slot already searched.
+        for (size_t pvIdx = 0; pvIdx < lines && !stopped; pvIdx++) {
+            searchRoot(board, d, pvIdx);
+        }
+        if (stopped) {
+            // The unfinished iteration's order, scores and PVs are unreliable; go back to the last complete one so
+            // bestmove and the final info line both match completedDepth
+            rootMoves.swap(completedRootMoves);
+            stats.depths.pop_back();
+            iterationStats = &scratchStats;
+            break;
+        }
+        completedDepth = d;
+
+        if (rootMoves[0].move != previousBest) bestMoveChanges += 1;
+
+        const int64_t elapsed = elapsedMs();
+        if (d == maxDepth || elapsed - lastInfo >= INFO_INTERVAL_MS) {
+            allocsBefore = AllocTracker::counts();
+            for (size_t i = 0; i < lines; i++) printInfo(d, static_cast<int>(i) + 1, rootMoves[i]);
+            stats.allocs.output += AllocTracker::counts() - allocsBefore;
+            lastInfo = elapsed;
+            printedDepth = d;
+        }
+
+        // Spend longer while the best move keeps changing, and less when it has soaked up nearly all the effort
+        if (optimumTime > 0) {
+            const double instability = 1.0 + bestMoveChanges;
+            const double effort = static_cast<double>(rootMoves[0].nodes) / static_cast<double>(std::max<uint64_t>(nodes, 1));
+            const double scale = instability * (effort > 0.9 ? 0.6 : 1.0);
+            if (static_cast<double>(elapsed) >= static_cast<double>(optimumTime) * scale) break;
+        }
+        bestMoveChanges /= 2;
+    }
+
+    // A limit ended the search; the GUI should still see the line behind bestmove
+    if (completedDepth > printedDepth) {
+        allocsBefore = AllocTracker::counts();
+        for (size_t i = 0; i < lines; i++) printInfo(completedDepth, static_cast<int>(i) + 1, rootMoves[i]);
+        stats.allocs.output += AllocTracker::counts() - allocsBefore;
+    }
+    return rootMoves[0].move;
+}
+
+void Search::initRootMoves(Board& board) {
+    rootMoves.clear();
+    std::vector<Move> moves = Generator::generatePseudoMoves(board);
+    orderMoves(moves, board);
+
     const Color side = board.getColor();
+    for (const Move& move : moves) {
+        MoveUndo undo = board.makeMove(move, false);
+        if (!board.isChecked(side)) rootMoves.emplace_back(move);
+        board.undoMove(undo);
+    }
+}
 
-    if (side == Color::White) {
-        int bestScore = -INF;
-        for (auto& move : moves) {
-            MoveUndo undo = board.makeMove(move, false);
-            if (board.isChecked(side)) {
-                board.undoMove(undo);
-                continue;
-            }
-            foundLegal = true;
-            int score = alphaBeta(board, depth - 1, 1, alpha, beta);
-            std::cout << Board::toUCI(move) << " score=" << score << "\n";
-            board.undoMove(undo);
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = move;
-            }
-            alpha = std::max(alpha, score);
-            if (beta <= alpha) break;
+void Search::allocateTime(const SearchLimits& limits, const Color side) {
+    optimumTime = 0;
+    maximumTime = 0;
+    if (limits.movetime > 0) {
+        maximumTime = std::max<int64_t>(limits.movetime - MOVE_OVERHEAD_MS, 1);
+        return;
+    }
+
+    const int64_t clock = side == Color::White ? limits.wtime : limits.btime;
+    const int64_t increment = side == Color::White ? limits.winc : limits.binc;
+    if (clock <= 0) return;
+
+    const int movesToGo = limits.movestogo > 0 ? std::min(limits.movestogo, 50) : 30;
+    const int64_t available = std::max<int64_t>(clock - MOVE_OVERHEAD_MS, 1);
+    maximumTime = std::max<int64_t>(std::min(available / 3, (available / movesToGo + increment) * 4), 1);
+    optimumTime = std::clamp<int64_t>(available / movesToGo + increment * 3 / 4, 1, maximumTime);
+}
+
+// Polled from every node; the clock is only read every 2048 nodes. The node limit is exact, so a node-limited
+// search from the same TT state always stops at the same node. Depth 1 always completes so there is a move to play.
+bool Search::shouldStop() {
+    if (stopped || rootDepth <= 1) return stopped;
+    if (nodeLimit > 0 && nodes >= nodeLimit) stopped = true;
+    if (maximumTime > 0 && (nodes & 2047) == 0 && elapsedMs() >= maximumTime) stopped = true;
+    return stopped;
+}
+
+void Search::searchRoot(Board& board, const int depth, const size_t pvIdx) {
+    const Color side = board.getColor();
+    const int us = (side == Color::White) ? 1 : -1;
+    int alpha = -INF;
+    int beta = INF;
+    int bestScore = -INF;
+    nodes++;
+
+    for (size_t i = pvIdx; i < rootMoves.size(); i++) {
+        RootMove& rm = rootMoves[i];
+        const uint64_t before = nodes;
+
+        const AllocCounts treeBefore = AllocTracker::counts();
+        MoveUndo undo = board.makeMove(rm.move, false);
+        pvLength[0] = 0;
+        const int score = us * (side == Color::White ? alphaBeta<Color::Black>(board, depth - 1, 1, alpha, beta)
+                                                     : alphaBeta<Color::White>(board, depth - 1, 1, alpha, beta));
+        board.undoMove(undo);
+        stats.allocs.tree += AllocTracker::counts() - treeBefore;
+        if (stopped) return;
+
+        rm.nodes += nodes - before;
+        rm.score = score;  // Moves that fail low keep their bound, which still orders them for the next pass
+        if (score > bestScore) {
+            bestScore = score;
+            updatePv(0, rm.move);
+            const AllocCounts pvBefore = AllocTracker::counts();
+            rm.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+            extendPvFromTT(board, rm.pv, depth);
+            stats.allocs.pv += AllocTracker::counts() - pvBefore;
+            if (side == Color::White) alpha = std::max(alpha, score);
+            else beta = std::min(beta, -score);
         }
-    } else {
-        int bestScore = INF;
-        for (auto& move : moves) {
-            MoveUndo undo = board.makeMove(move, false);
-            if (board.isChecked(side)) {
-                board.undoMove(undo);
-                continue;
-            }
-            foundLegal = true;
-            int score = alphaBeta(board, depth - 1, 1, alpha, beta);
-            std::cout << Board::toUCI(move) << " score=" << score << "\n";
+    }
+
+    // Best first; ties keep the previous order, so the incumbent survives equal scores
+    std::stable_sort(rootMoves.begin() + static_cast<std::ptrdiff_t>(pvIdx), rootMoves.end(),
+                     [](const RootMove& a, const RootMove& b) { return a.score > b.score; });
+}
+
+void Search::updatePv(const int ply, const Move& move) {
+    pvTable[ply][ply] = move;
+    for (int i = ply + 1; i < pvLength[ply + 1]; i++) {
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    }
+    pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+}
+
+// TT cutoffs return before a node writes its PV, which leaves lines short (always so for later Multi-PV slots).
+// Fill in the tail by following stored best moves, as long as they are legal in the position reached.
+void Search::extendPvFromTT(Board& board, std::vector<Move>& pv, const int depth) {
+    std::vector<MoveUndo> undos;
+    for (const Move& move : pv) undos.push_back(board.makeMove(move, false));
+
+    while (static_cast<int>(pv.size()) < depth) {
+        TTEntry* entry = tt.probe(board.getHash());
+        if (!entry) break;
+
+        const Move next = entry->bestMove;
+        const std::vector<Move> moves = Generator::generatePseudoMoves(board);
+        if (std::ranges::find(moves, next) == moves.end()) break;
+
+        const Color side = board.getColor();
+        MoveUndo undo = board.makeMove(next, false);
+        if (board.isChecked(side)) {
             board.undoMove(undo);
-            if (score < bestScore) {
-                bestScore = score;
-                bestMove = move;
-            }
-            beta = std::min(beta, score);
-            if (beta <= alpha) break;
+            break;
         }
+        undos.push_back(undo);
+        pv.push_back(next);
     }
 
-    if (!foundLegal) {
-        return Move{};
-    }
+    for (auto it = undos.rbegin(); it != undos.rend(); ++it) board.undoMove(*it);
+}
+
+int64_t Search::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count();
+}
 
-    return bestMove;
+// UCI info line for one PV slot of a finished iteration. Root move scores are already from the side to move.
+void Search::printInfo(const int depth, const int multipv, const RootMove& rootMove) {
+    if (!infoOutput) return;
+    const int64_t ms = elapsedMs();
+    const int score = rootMove.score;
+
+    std::cout << "info depth " << depth << " seldepth " << selDepth << " multipv " << multipv;
+    if (std::abs(score) >= MATE_BOUND) {
+        const int plies = MATE - std::abs(score);
+        std::cout << " score mate " << (score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2);
+    } else {
+        std::cout << " score cp " << score;
+    }
+    std::cout << " nodes " << nodes
+              << " nps " << nodes * 1000 / std::max<int64_t>(ms, 1)
+              << " hashfull " << tt.hashfull()
+              << " time " << ms
+              << " pv";
+    for (const Move& move : rootMove.pv) {
+        std::cout << " " << Board::toUCI(move);
+    }
+    std::cout << std::endl;
 }
 
-int Search::alphaBeta(Board &board, int depth, int ply, int alpha, int beta) {
+template<Color Us>
+int Search::alphaBeta(Board &board, int depth, int ply, int alpha, int beta, const Move* excluded) {
+    PROFILE_ZONE(AlphaBeta);
+    constexpr Color Them = opponent<Us>;
+    constexpr int us = (Us == Color::White) ? 1 : -1;
     const int originalAlpha = alpha;
     const int originalBeta = beta;
     bool foundLegal = false;
+    if (shouldStop()) return 0;
+    // The per-ply arrays end at MAX_PLY
+    if (ply >= MAX_PLY) return cachedEvaluate(board);
+    nodes++;
+    DepthStats& ds = *iterationStats;
+    ds.nodes++;
+    pvLength[ply] = ply;
+    selDepth = std::max(selDepth, ply);
+    // Neither side can mate, so nothing below can change the result
+    if (materialTable.probe(board).deadDraw) return 0;
 
     Move ttMove;
     bool hasTTMove = false;
+    int ttScore = 0;
+    int ttDepth = 0;
+    uint8_t ttFlag = 0;
 
     if (depth == 0) { // Don't stop if the board is still violent.
-        return quiescence(board, alpha, beta);
+        return quiescence<Us>(board, alpha, beta, ply);
     }
-    TTEntry* entry = tt.probe(board.getHash());
+    // Searches with an excluded move answer a different question, so they get their own TT slot
+    const uint64_t key = excluded ? board.getHash() ^ Zobrist::exclusion : board.getHash();
+    TTEntry* entry = tt.probe(key);
     if (entry) {
         ttMove = entry->bestMove;
-        hasTTMove = true;
+        hasTTMove = ttMove != Move{};  // Fail-low stores carry no move
+        ttScore = entry->score;
+        ttDepth = entry->depth;
+        ttFlag = entry->flag;
 
         if (entry->depth >= depth) {
-            if (entry->flag == EXACT) return entry->score;
+            if (entry->flag == EXACT) {
+                ds.ttCutoffs[EXACT]++;
+                return entry->score;
+            }
             if (entry->flag == LOWER_BOUND) alpha = std::max(alpha, entry->score);
             if (entry->flag == UPPER_BOUND) beta = std::min(beta, entry->score);
-            if (alpha >= beta) return alpha;
+            if (alpha >= beta) {
+                ds.ttCutoffs[entry->flag]++;
+                return alpha;
+            }
         }
     };
-    std::vector<Move> moves = Generator::generatePseudoMoves(board);
-    orderMoves(moves, board);
-    if (hasTTMove) {
-        for (size_t i = 0; i < moves.size(); i++) {
-            if (moves[i].current.r == ttMove.current.r &&
-                moves[i].current.c == ttMove.current.c &&
-                moves[i].destination.r == ttMove.destination.r &&
-                moves[i].destination.c == ttMove.destination.c) {
-                std::swap(moves[0], moves[i]);
-                break;
-                }
+    const bool inCheck = board.isChecked(Us);
+
+    // Scores flipped to the side to move so the pruning rules and the move loop below are written once
+    int usAlpha = (Us == Color::White) ? alpha : -beta;
+    const int usBeta = (Us == Color::White) ? beta : -alpha;
+
+    // No hash move means ordering here is poor; a shallower pass is cheaper and will seed the TT for next time
+    if (!hasTTMove && !excluded && depth >= params.iirDepth) {
+        depth--;
+        ds.iirReductions++;
+    }
+
+    // Shallow-depth pruning
+    bool futile = false;
+    const int maxPruneDepth = std::max({params.reverseFutilityDepth, params.futilityDepth, params.razorDepth});
+    if (!excluded && depth <= maxPruneDepth && !inCheck) {
+        const int staticEval = us * cachedEvaluate(board);
+
+        // Reverse futility: we are so far above beta that no quiet reply will bring it back
+        if (depth <= params.reverseFutilityDepth && std::abs(usBeta) < MATE_BOUND) {
+            const int margin = params.reverseFutilityMargin * depth;
+            if (staticEval - margin >= usBeta) {
+                ds.reverseFutility++;
+                return us * (staticEval - margin);
+            }
         }
+
+        // Razoring: hopelessly below alpha, only captures can save us
+        if (depth <= params.razorDepth && std::abs(usAlpha) < MATE_BOUND &&
+            staticEval + params.razorMargin[depth] <= usAlpha) {
+            const int score = quiescence<Us>(board, alpha, beta, ply);
+            if (us * score <= usAlpha) {
+                ds.razoring++;
+                return score;
+            }
+        }
+
+        // Futility: quiet moves can't raise us to alpha, only search tactical ones
+        futile = depth <= params.futilityDepth && std::abs(usAlpha) < MATE_BOUND &&
+                 staticEval + params.futilityMargin[depth] <= usAlpha;
     }
-    const Color side = board.getColor();
-    int bestScore;
-    Move bestMove;
-    if (side == Color::White) {
-        bestScore = -INF;
-        for (auto& move : moves) {
+
+    // ProbCut: if a capture that wins material still clears a raised beta at reduced depth, the full-depth
+    // search would almost surely fail high as well.
+    if (!excluded && !inCheck && depth >= params.probCutDepth && std::abs(usBeta) < MATE_BOUND) {
+        const int probBeta = usBeta + params.probCutMargin;
+        const auto [lo, hi] = whiteWindow<Us>(probBeta - 1, probBeta);
+        std::vector<Move>& captures = auxBuffers[ply];
+        captures.clear();
+        Generator::generateCaptures<Us>(board, captures);
+        orderMoves(captures, board);
+        for (const Move& move : captures) {
+            if (board.see(move) < 0) continue;
+
             MoveUndo undo = board.makeMove(move, false);
-            if (board.isChecked(side)) {
+            if (board.isChecked(Us)) {
                 board.undoMove(undo);
                 continue;
             }
-            foundLegal = true;
-            int score = alphaBeta(board, depth - 1, ply + 1, alpha, beta);
+            // Cheap qsearch check first, then confirm with the reduced-depth search
+            int score = quiescence<Them>(board, lo, hi, ply + 1);
+            if (us * score >= probBeta) {
+                score = alphaBeta<Them>(board, depth - params.probCutReduction, ply + 1, lo, hi);
+            }
             board.undoMove(undo);
-            alpha = std::max(alpha, score);
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = move;  // Track best move
+            if (stopped) return 0;
+
+            if (us * score >= probBeta) {
+                ds.probCuts++;
+                return score;
             }
-            bestScore = std::max(bestScore, score);
-            if (beta <= alpha) break;
         }
-        if (!foundLegal) {
-            if (board.isChecked(side)) {
-                return -MATE + ply;
-            }
-            return 0;
+    }
+
+    // Singular extension: if every other move fails low against a bar set below the TT score, the TT move
+    // is the only one that holds and deserves an extra ply. If the alternatives clear beta instead, several
+    // moves refute this node and it can be cut (multi-cut).
+    int singularExtension = 0;
+    const bool ttLowerBound = ttFlag == EXACT || ttFlag == (Us == Color::White ? LOWER_BOUND : UPPER_BOUND);
+    if (!excluded && ply > 0 && hasTTMove && depth >= params.singularDepth && ttDepth >= depth - 3 &&
+        ttLowerBound && std::abs(ttScore) < MATE_BOUND) {
+        const int singularBeta = us * ttScore - params.singularMargin * depth;
+        const int singularDepth = (depth - 1) / 2;
+        const auto [lo, hi] = whiteWindow<Us>(singularBeta - 1, singularBeta);
+        const int score = alphaBeta<Us>(board, singularDepth, ply, lo, hi, &ttMove);
+
+        pvLength[ply] = ply;  // The excluded search wrote its own line here
+        if (stopped) return 0;
+
+        if (us * score < singularBeta) {
+            singularExtension = 1;
+            ds.singularExtensions++;
+        } else if (singularBeta >= usBeta) {
+            ds.multiCuts++;
+            return us * singularBeta;
         }
+    }
 
-        // White is maximizing
-        uint8_t flag;
-        if (bestScore <= originalAlpha) {
-            flag = UPPER_BOUND;  // Never improved alpha, this is the best we can do (or worse)
-        } else if (bestScore >= originalBeta) {
-            flag = LOWER_BOUND;  // Score is at least this good (caused beta cutoff)
-        } else {
-           flag = EXACT;
+    // Generated only now: the singular search above runs at this same ply and shares the buffer
+    std::vector<Move>& moves = moveBuffers[ply];
+    moves.clear();
+    Generator::generatePseudoMoves<Us>(board, moves);
+    orderMoves(moves, board);
+    if (hasTTMove) {
+        auto it = std::find(moves.begin(), moves.end(), ttMove);
+        if (it != moves.end()) std::swap(moves[0], *it);
+    }
+
+    int bestScore = -INF;
+    Move bestMove{};  // Stays null unless a move raises alpha
+    int searched = 0;
+    ds.moveLoops++;
+    for (const Move& move : moves) {
+        if (excluded && move == *excluded) continue;
+        const bool checks = board.givesCheck(move);
+        if (futile && foundLegal && !checks && isQuiet(move, board)) {
+            ds.futilityPrunes++;
+            continue;
         }
-        tt.store(board.getHash(), bestScore, depth, flag, bestMove);
-    } else {
-        bestScore = INF;
-        for (auto& move : moves) {
-            MoveUndo undo = board.makeMove(move, false);
-            if (board.isChecked(side)) {
-                board.undoMove(undo);
-                continue;
-            }
-            foundLegal = true;
 
-            int score = alphaBeta(board, depth - 1, ply + 1, alpha, beta);
+        MoveUndo undo = board.makeMove(move, false);
+        if (board.isChecked(Us)) {
             board.undoMove(undo);
+            continue;
+        }
+        foundLegal = true;
+        searched++;
+        // Check and singular extensions, capped so forcing lines can't run away
+        int extension = checks ? 1 : 0;
+        if (hasTTMove && move == ttMove) extension = std::max(extension, singularExtension);
+        if (ply >= 2 * rootDepth) extension = 0;
+        extension = std::min(extension, std::max(0, MAX_PLY - 1 - ply - depth));  // Keep the line inside MAX_PLY
+        if (checks && extension > 0) ds.checkExtensions++;
+
+        const auto [lo, hi] = whiteWindow<Us>(usAlpha, usBeta);
+        const int score = us * alphaBeta<Them>(board, depth - 1 + extension, ply + 1, lo, hi);
+        board.undoMove(undo);
+        if (stopped) return 0;
 
-            if (score < bestScore) {
-                bestScore = score;
-                bestMove = move;
-            }
-            beta = std::min(beta, score);
-            if (beta <= alpha) break;
+        if (score > bestScore) bestScore = score;
+        if (score > usAlpha) {
+            usAlpha = score;
+            bestMove = move;
+            updatePv(ply, move);
         }
-        if (!foundLegal) {
-            if (board.isChecked(side)) {
-                return MATE + ply;
-            }
-            return 0;
+        if (usAlpha >= usBeta) {
+            ds.betaCutoffs++;
+            if (searched == 1) ds.firstMoveCutoffs++;
+            break;
         }
+    }
+    if (!foundLegal) {
+        if (excluded) return us * usAlpha;  // Only the excluded move was playable
+        return inCheck ? us * (-MATE + ply) : 0;
+    }
 
-        // Black is minimizing
-        uint8_t flag;
-        if (bestScore >= originalBeta) {
-            flag = LOWER_BOUND;  // Couldn't beat beta, score is at least this
-        } else if (bestScore <= originalAlpha) {
-            flag = UPPER_BOUND;  // Beat alpha (bad for white), score is at most this
-        } else {
-            flag = EXACT;
-        }
-        tt.store(board.getHash(), bestScore, depth, flag, bestMove);
+    // Back to White's point of view for the TT
+    bestScore *= us;
+    uint8_t flag;
+    if (bestScore <= originalAlpha) {
+        flag = UPPER_BOUND;  // Never improved alpha, this is the best we can do (or worse)
+    } else if (bestScore >= originalBeta) {
+        flag = LOWER_BOUND;  // Score is at least this good (caused beta cutoff)
+    } else {
+        flag = EXACT;
     }
+    if (!stopped) tt.store(key, bestScore, depth, flag, bestMove);
     return bestScore;
 }
 
-int Search::quiescence(Board& board, int alpha, int beta, int qDepth) {
-    int stand_pat = evaluate(board);
-    Color side = board.getColor();
-    if (qDepth >= 8) return stand_pat;
+template<Color Us>
+int Search::quiescence(Board& board, int alpha, int beta, int ply, int qDepth) {
+    PROFILE_ZONE(Quiescence);
+    constexpr Color Them = opponent<Us>;
+    constexpr int us = (Us == Color::White) ? 1 : -1;
+    if (shouldStop()) return 0;
+    if (ply >= MAX_PLY) return cachedEvaluate(board);
+    nodes++;
+    DepthStats& ds = *iterationStats;
+    ds.qnodes++;
+    pvLength[ply] = ply;
+    selDepth = std::max(selDepth, ply);
+    if (materialTable.probe(board).deadDraw) return 0;
 
-    if (side == Color::White) {
-        if (stand_pat >= beta) return beta;
+    const int originalAlpha = alpha;
+    const int originalBeta = beta;
+    Move ttMove;
+    bool hasTTMove = false;
 
-        int delta = 900;  // Queen value - biggest possible gain
-        if (stand_pat + delta < alpha) return alpha;
+    TTEntry* entry = tt.probe(board.getHash());
+    if (entry) {
+        ttMove = entry->bestMove;
+        hasTTMove = ttMove != Move{};  // Fail-low stores carry no move
 
-        if (stand_pat > alpha) alpha = stand_pat;
-    } else {
-        if (stand_pat <= alpha) return alpha;
+        // Any stored result is at least as deep as a quiescence search
+        if (entry->flag == EXACT) return entry->score;
+        if (entry->flag == LOWER_BOUND) alpha = std::max(alpha, entry->score);
+        if (entry->flag == UPPER_BOUND) beta = std::min(beta, entry->score);
+        if (alpha >= beta) return alpha;
+    }
 
-        int delta = 900;
-        if (stand_pat - delta > beta) return beta;
+    const bool inCheck = board.isChecked(Us);
+    int usAlpha = (Us == Color::White) ? alpha : -beta;
+    const int usBeta = (Us == Color::White) ? beta : -alpha;
+    std::vector<Move>& moves = moveBuffers[ply];
+    moves.clear();
+    int stand_pat = 0;
+
+    if (inCheck) {
+        // In check there is no standing pat: every evasion has to be tried, and having none is mate.
+        Generator::generatePseudoMoves<Us>(board, moves);
+        orderMoves(moves, board);
+    } else {
+        stand_pat = us * cachedEvaluate(board, alpha, beta);
+        if (stand_pat >= usBeta) return us * usBeta;
+        if (stand_pat > usAlpha) usAlpha = stand_pat;
+
+        Generator::generateCaptures<Us>(board, moves);
+        orderMoves(moves, board);
+
+        // The first ply also looks at quiet checks so mates just past the horizon aren't missed
+        if (qDepth == 0) {
+            std::vector<Move>& all = auxBuffers[ply];
+            all.clear();
+            Generator::generatePseudoMoves<Us>(board, all);
+            for (const Move& move : all) {
+                if (isQuiet(move, board) && board.givesCheck(move)) moves.push_back(move);
+            }
+        }
+    }
 
-        if (stand_pat < beta) beta = stand_pat;
+    if (hasTTMove) {
+        auto it = std::find(moves.begin(), moves.end(), ttMove);
+        if (it != moves.end()) std::rotate(moves.begin(), it, it + 1);
     }
-    std::vector<Move> caps;
-    caps = Generator::generateCaptures(board);
-    orderMoves(caps, board);
 
-    for (const Move& move : caps) {
-        if (board.at(move.destination.r, move.destination.c).kind == PieceKind::None)
-            continue;
+    bool foundLegal = false;
+    Move bestMove{};  // Stays null unless a move raises alpha
+    for (const Move& move : moves) {
+        if (!inCheck) {
+            // Delta pruning against what this particular capture can win. stand_pat may be the lazy cheap tier, so
+            // this also assumes the expensive terms would not have added more than LAZY_MARGIN; in the rare
+            // position where they would, a capture that restores alpha is pruned.
+            int gain = (move.type == MoveType::EnPassant)
+                ? pieceValue(PieceKind::Pawn)
+                : pieceValue(board.at(move.destination.r, move.destination.c).kind);
+            if (move.type == MoveType::Promotion) gain += pieceValue(move.promotion) - pieceValue(PieceKind::Pawn);
+
+            if (stand_pat + gain + params.deltaMargin <= usAlpha) {
+                ds.deltaPrunes++;
+                continue;
+            }
+
+            // Losing exchanges never improve on standing pat; dropping them is what bounds the search
+            if (board.see(move) < 0) {
+                ds.seePrunes++;
+                continue;
+            }
+        }
+
         MoveUndo undo = board.makeMove(move, false);
-        if (board.isChecked(side)) {
+        if (board.isChecked(Us)) {
             board.undoMove(undo);
             continue;
         }
-        int score = quiescence(board, alpha, beta, qDepth + 1);
+        foundLegal = true;
+        const auto [lo, hi] = whiteWindow<Us>(usAlpha, usBeta);
+        const int score = us * quiescence<Them>(board, lo, hi, ply + 1, qDepth + 1);
         board.undoMove(undo);
+        if (stopped) return 0;
 
-        if (side == Color::White) {
-            if (score > alpha) alpha = score;
-            if (alpha >= beta) return beta;
-        } else {
-            if (score < beta) beta = score;
-            if (beta <= alpha) return alpha;
+        if (score > usAlpha) {
+            usAlpha = score;
+            bestMove = move;
         }
+        if (usAlpha >= usBeta) break;
     }
 
-    return side == Color::White ? alpha : beta;
+    if (inCheck && !foundLegal) return us * (-MATE + ply);
+
+    const int result = us * std::min(usAlpha, usBeta);
+    uint8_t flag;
+    if (result <= originalAlpha) {
+        flag = UPPER_BOUND;
+    } else if (result >= originalBeta) {
+        flag = LOWER_BOUND;
+    } else {
+        flag = EXACT;
+    }
+    if (!stopped) tt.store(board.getHash(), result, 0, flag, bestMove);
+    return result;
 }
 
 int Search::computePhase(const Board& board) {
     int phase = 0;
 
-    for (auto& piece : board.pieces()) {
-        switch (piece.kind) {
-            case PieceKind::Knight: phase += PHASE_KNIGHT; break;
-            case PieceKind::Bishop: phase += PHASE_BISHOP; break;
-            case PieceKind::Rook: phase += PHASE_ROOK; break;
-            case PieceKind::Queen: phase += PHASE_QUEEN; break;
-            default: break;
+    for (int r = 0; r < 8; r++) {
+        for (int c = 0; c < 8; c++) {
+            switch (board.at(r, c).kind) {
+                case PieceKind::Knight: phase += PHASE_KNIGHT; break;
+                case PieceKind::Bishop: phase += PHASE_BISHOP; break;
+                case PieceKind::Rook: phase += PHASE_ROOK; break;
+                case PieceKind::Queen: phase += PHASE_QUEEN; break;
+                default: break;
+            }
         }
     }
 
@@ -264,226 +659,227 @@ int Search::mvvLva(const Move& move, const Board& board) {
     return victim * 10 - attacker;
 }
 
-void Search::orderMoves(std::vector<Move>& moves, const Board& board) {
-    std::vector<int> score(moves.size());
+// Captures, en passant and promotions are tactical; everything else (castling included) is quiet.
+bool Search::isQuiet(const Move& move, const Board& board) {
+    if (move.type == MoveType::Promotion || move.type == MoveType::EnPassant) return false;
+    return board.at(move.destination.r, move.destination.c).kind == PieceKind::None;
+}
 
-    for (size_t i = 0; i < moves.size(); i++) {
-        score[i] = mvvLva(moves[i], board);
+void Search::orderMoves(std::vector<Move>& moves, const Board& board) {
+    // Scratch on the stack keeps ordering allocation-free; only an absurd pseudo-legal count spills to the heap
+    struct ScoredMove {
+        int score;
+        uint16_t index;
+    };
+    constexpr size_t MAX_MOVES = 256;
+    ScoredMove stackScratch[MAX_MOVES];
+    std::vector<ScoredMove> heapScratch;
+    const size_t n = moves.size();
+    ScoredMove* scored = stackScratch;
+    if (n > MAX_MOVES) {
+        heapScratch.resize(n);
+        scored = heapScratch.data();
     }
 
-    std::vector<size_t> idx(moves.size());
-    std::iota(idx.begin(), idx.end(), 0);
+    for (size_t i = 0; i < n; i++) {
+        scored[i] = {mvvLva(moves[i], board), static_cast<uint16_t>(i)};
+    }
 
-    std::sort(idx.begin(), idx.end(), [&](size_t i, size_t j) {
-        return score[i] > score[j];
+    std::sort(scored, scored + n, [](const ScoredMove& a, const ScoredMove& b) {
+        return a.score > b.score;
     });
 
-    std::vector<Move> ordered;
-    ordered.reserve(moves.size());
-    for (auto i : idx) ordered.push_back(moves[i]);
-
-    moves.swap(ordered);
+    // Apply the permutation in place, one cycle at a time; visited slots are marked by pointing at themselves
+    for (size_t i = 0; i < n; i++) {
+        if (scored[i].index == i) continue;
+        const Move first = moves[i];
+        size_t j = i;
+        while (true) {
+            const size_t k = scored[j].index;
+            scored[j].index = static_cast<uint16_t>(j);
+            if (k == i) {
+                moves[j] = first;
+                break;
+            }
+            moves[j] = moves[k];
+            j = k;
+        }
+    }
 }
 
-int Search::evaluate(const Board &board) {
+namespace {
+// Indexed by Zobrist piece order; pawns and kings have no entries. Mobility counts squares not held by our own
+// pieces or covered by enemy pawns, relative to a typical count. Early on an active queen is a target, not an asset.
+constexpr int MOBILITY_BASE[6] = {0, 4, 6, 7, 13, 0};
+constexpr int MOBILITY_EARLY[6] = {0, 4, 5, 2, 0, 0};
+constexpr int MOBILITY_LATE[6] = {0, 4, 5, 4, 2, 0};
+constexpr int KING_ATTACK_WEIGHT[6] = {0, 2, 2, 3, 5, 0};  // Per king-zone square attacked
+constexpr int KING_DANGER_SCALE = 6;
+constexpr int KING_DANGER_MAX = 300;
+constexpr int HANGING = 40;       // Piece attacked and undefended
+constexpr int PAWN_THREAT = 50;   // Piece attacked by a pawn
+
+// White-relative mobility, king-zone attacks and threats against pieces
+int attackTerms(const AttackMaps& maps, const Board& board, const double phase) {
     int score = 0;
+    uint64_t kingZone[2] = {};
+    for (const Color color : {Color::White, Color::Black}) {
+        const Square king = board.kingSquare(color);
+        if (king.r < 0) continue;
+        const int square = king.r * 8 + king.c;
+        kingZone[Zobrist::colorIndex(color)] = AttackMaps::kingAttacks(square) | uint64_t{1} << square;
+    }
 
-    double phase = computePhase(board) / static_cast<double>(MAX_PHASE);
-    phase = std::clamp(phase, 0.0, 1.0);
+    int16_t mobilityWeight[6];
+    for (int kind = 0; kind < 6; kind++) {
+        mobilityWeight[kind] = static_cast<int16_t>(std::round(MOBILITY_EARLY[kind] * phase + MOBILITY_LATE[kind] * (1.0 - phase)));
+    }
 
-    auto enemyPieceAheadOnFile = [&](const int r, const int file, const int dr, const int dc, const Color color, const PieceKind piece) {
-        return board.rayScan(r, file, dr, dc,
-            [&](const Piece& p) {
-                return p.kind == piece && p.color != color;
-            }
-        );
-    };
+    // Gather the masks for the popcount kernel: reachable squares per piece, and king-zone hits by the attacked
+    // king's colour
+    uint64_t reachable[AttackMaps::MAX_PIECES];
+    int16_t reachableWeight[AttackMaps::MAX_PIECES];
+    uint64_t zoneHits[2][AttackMaps::MAX_PIECES];
+    int16_t zoneWeight[2][AttackMaps::MAX_PIECES];
+    int kingAttackers[2] = {};
+    for (int i = 0; i < maps.pieceCount; i++) {
+        const AttackMaps::PieceAttacks& piece = maps.pieces[i];
+        const int them = 1 - piece.color;
+        const int kind = Zobrist::pieceIndex(piece.kind);
+        const int sign = piece.color == 0 ? 1 : -1;
+
+        reachable[i] = piece.attacks & ~maps.byColor[piece.color] & ~maps.pawnAttacks[them];
+        reachableWeight[i] = static_cast<int16_t>(sign * mobilityWeight[kind]);
+        score -= sign * MOBILITY_BASE[kind] * mobilityWeight[kind];
+
+        if (const uint64_t zone = piece.attacks & kingZone[them]) {
+            zoneHits[them][kingAttackers[them]] = zone;
+            zoneWeight[them][kingAttackers[them]++] = KING_ATTACK_WEIGHT[kind];
+        }
+    }
+    score += Simd::weightedPopcount(reachable, reachableWeight, maps.pieceCount);
+
+    for (int color = 0; color < 2; color++) {
+        const int sign = color == 0 ? 1 : -1;
+        // A lone attacker is rarely dangerous
+        if (kingAttackers[color] >= 2) {
+            const int weight = Simd::weightedPopcount(zoneHits[color], zoneWeight[color], kingAttackers[color]);
+            const int danger = std::min(weight * KING_DANGER_SCALE, KING_DANGER_MAX);
+            score -= sign * static_cast<int>(std::round(danger * phase));
+        }
 
-    auto allowedSquares = [&](const int r, const int file, const int dr, const int dc) {
-        return board.rayScanCount(r, file, dr, dc,
-            [&](const Piece& p) {
-                return p.kind != PieceKind::None;
-            });
-    };
+        const uint64_t pieces = maps.byColor[color] & ~maps.byKind[color][0] & ~maps.byKind[color][5];
+        const int hanging = std::popcount(pieces & maps.attacks[1 - color] & ~maps.attacks[color]);
+        const int threatened = std::popcount(pieces & maps.pawnAttacks[1 - color]);
+        score -= sign * (hanging * HANGING + threatened * PAWN_THREAT);
+    }
+    return score;
+}
 
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
-            const auto [kind, color] = board.at(r, c);
-            if (kind == PieceKind::None) continue;
-
-            const int sign = (color == Color::White) ? 1 : -1;
-
-            // material
-            score += pieceValue(kind) * sign;
-
-            // PST coordinates
-            int pst_row = (color == Color::White) ? r : 7 - r; // reverse for black
-            int pst_col = c;
-
-            int pstScore = 0;
-            int dr = (color == Color::White) ? -1 : 1;
-
-            switch (kind) {
-                case PieceKind::Knight:
-                    pstScore = static_cast<int>(std::round(
-                        knightPST_EARLY[pst_row][pst_col] * phase +
-                        knightPST_LATE[pst_row][pst_col] * (1.0 - phase)
-                    ));
-                    break;
-
-                case PieceKind::Bishop: {
-                    pstScore = static_cast<int>(std::round(
-                        bishopPST_EARLY[pst_row][pst_col] * phase +
-                        bishopPST_LATE[pst_row][pst_col] * (1.0 - phase)
-                    ));
-                    if (color == Color::White) {
-                        if (r == 5 && c == 3) { // d3
-                            Piece dPawn = board.at(6, 3);  // d2
-                            if (dPawn.kind == PieceKind::Pawn && dPawn.color == Color::White) {
-                                pstScore -= 30;  // Penalty for blocking d-pawn
-                            }
-                        } else if (r == 5 && c == 4) { // e3
-                            Piece dPawn = board.at(6, 4);  // e2
-                            if (dPawn.kind == PieceKind::Pawn && dPawn.color == Color::White) {
-                                pstScore -= 30;  // Penalty for blocking e-pawn
-                            }
-                        }
-                    } else {
-                        // Black bishop on d6 blocking d7 pawn
-                        if (r == 2 && c == 3) {  // d6
-                            Piece dPawn = board.at(1, 3);  // d7
-                            if (dPawn.kind == PieceKind::Pawn && dPawn.color == Color::Black) {
-                                pstScore -= 30;  // Penalty (will become +30 for white after * sign)
-                            }
-                        }
-                        // Black bishop on e6 blocking e7 pawn
-                        else if (r == 2 && c == 4) {  // e6
-                            Piece ePawn = board.at(1, 4);  // e7
-                            if (ePawn.kind == PieceKind::Pawn && ePawn.color == Color::Black) {
-                                pstScore -= 30;
-                            }
-                        }
-                    }
-
-                    const int left_dig = allowedSquares(r, c, dr, -1);
-                    const int right_dig = allowedSquares(r, c, dr, 1);
-                    const int left_back_dig = allowedSquares(r, c, -dr, -1);
-                    const int right_back_dig = allowedSquares(r, c, -dr, 1);
-
-                    pstScore += static_cast<int>(std::round((left_dig + right_dig + left_back_dig * 0.5 + right_back_dig * 0.5) * 2 * phase));
-                    break;
-                }
-
-                case PieceKind::Rook: {
-                    pstScore = static_cast<int>(std::round(
-                        rookPST_EARLY[pst_row][pst_col] * phase +
-                        rookPST_LATE[pst_row][pst_col] * (1.0 - phase)
-                    ));
-                    const int forward = allowedSquares(r, c, dr, 0);
-                    const int backward = allowedSquares(r, c, -1, 0);
-                    const int left = allowedSquares(r, c, 0, -1);
-                    const int right = allowedSquares(r, c, 0, 1);
-                    pstScore += static_cast<int>(std::round((forward + backward + left * 0.5 + right * 0.5) * 2 * phase));
-                    break;
-                }
-
-                case PieceKind::Queen:
-                    pstScore = static_cast<int>(std::round(
-                        queenPST_EARLY[pst_row][pst_col] * phase +
-                        queenPST_LATE[pst_row][pst_col] * (1.0 - phase)
-                    ));
-                    break;
-
-                case PieceKind::King: {
-                    pstScore = static_cast<int>(std::round(
-                        kingPST_EARLY[pst_row][pst_col] * phase +
-                        kingPST_LATE[pst_row][pst_col] * (1.0 - phase)
-                    ));
-
-                    // King safety - only in early/mid game (phase > 0.3)
-                    if (phase > 0.3) {
-                        if (color == Color::White) {
-                            // Kingside castled (king on g1 or h1)
-                            if (r == 7 && (c == 6 || c == 7)) {
-                                int shield = 0;
-                                // Check pawns on f2, g2, h2 xor h3
-                                if (board.at(6, 5).kind == PieceKind::Pawn && board.at(6, 5).color == Color::White) shield++;
-                                if (board.at(6, 6).kind == PieceKind::Pawn && board.at(6, 6).color == Color::White) shield++;
-                                if ((board.at(6, 7).kind == PieceKind::Pawn && board.at(6, 7).color == Color::White) ^
-                                    (board.at(5, 7).kind == PieceKind::Pawn && board.at(5, 7).color == Color::White)) shield++;
-
-                                // Bonus for intact shield, penalty for missing pawns
-                                pstScore += (shield - 3) * 15;  // -45 if no pawns, 0 if all 3
-
-                                // Extra penalty for open file in front of king
-                                if (board.at(6, 6).color != Color::White && board.at(5, 6).color != Color::White) {
-                                    pstScore -= 25;  // Open g-file is dangerous
-                                }
-                            }
-                            // Queenside castled (king on c1 or b1)
-                            else if (r == 7 && (c == 1 || c == 2)) {
-                                int shield = 0;
-                                // Check pawns on a2, b2, c2
-                                if (board.at(6, 0).kind == PieceKind::Pawn && board.at(6, 0).color == Color::White) shield++;
-                                if (board.at(6, 1).kind == PieceKind::Pawn && board.at(6, 1).color == Color::White) shield++;
-                                if (board.at(6, 2).kind == PieceKind::Pawn && board.at(6, 2).color == Color::White) shield++;
-
-                                pstScore += (shield - 3) * 15;
-                            }
-                        } else {
-                            // Black kingside castled (king on g8 or h8)
-                            if (r == 0 && (c == 6 || c == 7)) {
-                                int shield = 0;
-                                // Check pawns on f7, g7, h7 xor h6
-                                if (board.at(1, 5).kind == PieceKind::Pawn && board.at(1, 5).color == Color::Black) shield++;
-                                if (board.at(1, 6).kind == PieceKind::Pawn && board.at(1, 6).color == Color::Black) shield++;
-                                if ((board.at(1, 7).kind == PieceKind::Pawn && board.at(1, 7).color == Color::Black) ^
-                                    (board.at(2, 7).kind == PieceKind::Pawn && board.at(2, 7).color == Color::Black)) shield++;
-
-                                pstScore += (shield - 3) * 15;
-
-                                // Open g-file penalty
-                                if (board.at(1, 6).color != Color::Black && board.at(2, 6).color != Color::Black) {
-                                    pstScore -= 25;
-                                }
-                            }
-                            // Black queenside castled (king on c8 or b8)
-                            else if (r == 0 && (c == 1 || c == 2)) {
-                                int shield = 0;
-                                if (board.at(1, 0).kind == PieceKind::Pawn && board.at(1, 0).color == Color::Black) shield++;
-                                if (board.at(1, 1).kind == PieceKind::Pawn && board.at(1, 1).color == Color::Black) shield++;
-                                if (board.at(1, 2).kind == PieceKind::Pawn && board.at(1, 2).color == Color::Black) shield++;
-
-                                pstScore += (shield - 3) * 15;
-                            }
-                        }
-                    }
-                    break;
-                }
-
-                case PieceKind::Pawn: {
-                    pstScore = pawnPST[pst_row][pst_col];
-                    bool sameFile = enemyPieceAheadOnFile(r, c, dr, 0, color, PieceKind::Pawn);
-                    bool leftFile  = ((c > 0) && enemyPieceAheadOnFile(r, c - 1, dr, 0, color, PieceKind::Pawn));
-                    bool rightFile = ((c < 7) && enemyPieceAheadOnFile(r, c + 1, dr, 0, color, PieceKind::Pawn));
-
-                    if (!sameFile && !leftFile && !rightFile) {
-                        int rankBonus = (color == Color::White) ? (7 - r) : r;  // 0-6, higher = more advanced
-                        pstScore += 10 + rankBonus * 15;  // 10 to 100 based on rank
-                    }
-                    break;
-                }
-                default:
-                    break;
-            }
+// A bishop on d3/e3 (d6/e6) in front of its own unmoved centre pawn
+int blockedCentrePawns(const AttackMaps& maps) {
+    int score = 0;
+    for (const int c : {3, 4}) {
+        if ((maps.byKind[0][2] & AttackMaps::bit(5, c)) && (maps.byKind[0][0] & AttackMaps::bit(6, c))) score -= 30;
+        if ((maps.byKind[1][2] & AttackMaps::bit(2, c)) && (maps.byKind[1][0] & AttackMaps::bit(1, c))) score += 30;
+    }
+    return score;
+}
 
-            score += pstScore * sign;
+// A castled king wants its pawn shield intact and, on the kingside, the g-file closed in front of it
+int kingShelter(const Board& board, const PawnEntry& pawns) {
+    int score = 0;
+    for (const Color color : {Color::White, Color::Black}) {
+        const int side = Zobrist::colorIndex(color);
+        const int home = color == Color::White ? 7 : 0;
+        const int forward = color == Color::White ? -1 : 1;
+        const Square king = board.kingSquare(color);
+        if (king.r != home) continue;
+
+        int shelter = 0;
+        if (king.c == 6 || king.c == 7) {
+            shelter = (pawns.shield[side][PawnEntry::Kingside] - 3) * 15;  // -45 with no pawns, 0 with all three
+            if (board.at(home + forward, 6).color != color && board.at(home + 2 * forward, 6).color != color) {
+                shelter -= 25;
+            }
+        } else if (king.c == 1 || king.c == 2) {
+            shelter = (pawns.shield[side][PawnEntry::Queenside] - 3) * 15;
         }
+        score += color == Color::White ? shelter : -shelter;
     }
+    return score;
+}
+}
 
+// Transpositions reach the same quiescence leaves many times over, so most static evaluations are repeats
+int Search::cachedEvaluate(const Board& board, const int alpha, const int beta) {
+    DepthStats& ds = *iterationStats;
+    ds.evaluations++;
+    int score;
+    if (evalCache.probe(board.getHash(), score)) {
+        ds.evalCacheHits++;
+        return score;
+    }
+    if (nnueActive() && board.getAccumulators()) {
+        const MaterialEntry& material = materialTable.probe(board);
+        score = material.deadDraw ? 0
+              : material.endgame ? material.endgame(board, material.strong)
+              : network->evaluate(board, *board.getAccumulators());
+        evalCache.store(board.getHash(), score);
+        return score;
+    }
+    const uint64_t pawnHits = pawnTable.hits;
+    bool exact;
+    score = evaluate(board, &pawnTable, &materialTable, alpha, beta, exact);
+    ds.pawnTableHits += pawnTable.hits - pawnHits;
+    // A lazy score only holds for this window, so it mustn't be served to a later caller
+    if (exact) evalCache.store(board.getHash(), score);
+    else ds.lazyEvals++;
     return score;
 }
 
+int Search::evaluate(const Board& board, PawnTable* pawnTable, MaterialTable* materialTable) {
+    bool exact;
+    return evaluate(board, pawnTable, materialTable, -INF, INF, exact);
+}
+
+int Search::evaluate(const Board &board, PawnTable* pawnTable, MaterialTable* materialTable, const int alpha,
+                     const int beta, bool& exact) {
+    PROFILE_ZONE(Evaluate);
+    exact = true;
+    MaterialEntry computedMaterial;
+    const MaterialEntry& material = materialTable ? materialTable->probe(board)
+                                                  : (computedMaterial = MaterialTable::compute(board));
+    if (material.deadDraw) return 0;
+    if (material.endgame) return material.endgame(board, material.strong);
+
+    PawnEntry computed;
+    const PawnEntry& pawns = pawnTable ? pawnTable->probe(board) : (computed = PawnTable::compute(board));
+
+    double phase = material.phase / static_cast<double>(MAX_PHASE);
+    phase = std::clamp(phase, 0.0, 1.0);
+
+    auto scaled = [&](const int score) {
+        return score * material.scale[score > 0 ? 0 : 1] / MaterialEntry::SCALE_NORMAL;
+    };
+
+    // Cheap tier: incremental material and piece-square sums plus the cached pawn and material terms
+    int score = board.getMaterialScore() + pawns.score + material.imbalance
+        + static_cast<int>(std::round(board.getPstEarly() * phase + board.getPstLate() * (1.0 - phase)));
+    const int cheap = scaled(score);
+    if (cheap - LAZY_MARGIN >= beta || cheap + LAZY_MARGIN <= alpha) {
+        exact = false;
+        return cheap;
+    }
+
+    // Expensive tier: one attack-map pass for mobility, king danger and threats, then the pawn-shape terms
+    const AttackMaps maps(board);
+    score += attackTerms(maps, board, phase) + blockedCentrePawns(maps);
+    if (phase > 0.3) score += kingShelter(board, pawns);  // Only in early/mid game
+
+    return scaled(score);
+}
+
 void Search::updatePST(const double phase) {
     if (std::abs(phase - lastPhase) < 0.01) return;  // Skip if phase hasn't changed much
     lastPhase = phase;
@@ -0,0 +1,99 @@
+#include "search/search_stats.h"
+
+#include <iomanip>
+
+void DepthStats::merge(const DepthStats& other) {
+    nodes += other.nodes;
+    qnodes += other.qnodes;
+    moveLoops += other.moveLoops;
+    betaCutoffs += other.betaCutoffs;
+    firstMoveCutoffs += other.firstMoveCutoffs;
+    for (int i = 0; i < 3; i++) ttCutoffs[i] += other.ttCutoffs[i];
+    reverseFutility += other.reverseFutility;
+    razoring += other.razoring;
+    futilityPrunes += other.futilityPrunes;
+    probCuts += other.probCuts;
+    singularExtensions += other.singularExtensions;
+    multiCuts += other.multiCuts;
+    checkExtensions += other.checkExtensions;
+    iirReductions += other.iirReductions;
+    deltaPrunes += other.deltaPrunes;
+    seePrunes += other.seePrunes;
+    evaluations += other.evaluations;
+    evalCacheHits += other.evalCacheHits;
+    pawnTableHits += other.pawnTableHits;
+    lazyEvals += other.lazyEvals;
+}
+
+void AllocStats::merge(const AllocStats& other) {
+    setup += other.setup;
+    tree += other.tree;
+    pv += other.pv;
+    output += other.output;
+}
+
+void AllocStats::print(std::ostream& out, const uint64_t nodes) const {
+    const double perNode = 1.0 / static_cast<double>(nodes > 0 ? nodes : 1);
+    const auto phase = [&](const char* name, const AllocCounts& counts) {
+        out << " " << name << "=" << counts.allocations << "/" << counts.bytes << "B";
+    };
+    out << "allocs";
+    phase("setup", setup);
+    phase("tree", tree);
+    phase("pv", pv);
+    phase("output", output);
+    const uint64_t total = setup.allocations + tree.allocations + pv.allocations + output.allocations;
+    const uint64_t bytes = setup.bytes + tree.bytes + pv.bytes + output.bytes;
+    out << " per_node=" << static_cast<double>(total) * perNode
+        << " bytes_per_node=" << static_cast<double>(bytes) * perNode << "\n";
+}
+
+void SearchStats::merge(const SearchStats& other) {
+    allocs.merge(other.allocs);
+    if (depths.size() < other.depths.size()) depths.resize(other.depths.size());
+    for (size_t i = 0; i < other.depths.size(); i++) depths[i].merge(other.depths[i]);
+}
+
+namespace {
+double percent(const uint64_t part, const uint64_t whole) {
+    return whole > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+}
+
+void SearchStats::print(std::ostream& out) const {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+
+    out << "depth      nodes     qnodes   cut%  first%    ebf  tt exact/lower/upper\n";
+    for (size_t i = 0; i < depths.size(); i++) {
+        const DepthStats& d = depths[i];
+        const uint64_t total = d.nodes + d.qnodes;
+        const uint64_t previous = i > 0 ? depths[i - 1].nodes + depths[i - 1].qnodes : 0;
+        out << std::setw(5) << (i + 1)
+            << std::setw(11) << d.nodes
+            << std::setw(11) << d.qnodes
+            << std::setw(7) << percent(d.betaCutoffs, d.moveLoops)
+            << std::setw(8) << percent(d.firstMoveCutoffs, d.betaCutoffs)
+            << std::setw(7);
+        if (previous > 0) out << static_cast<double>(total) / static_cast<double>(previous);
+        else out << "-";
+        out << "  " << d.ttCutoffs[0] << "/" << d.ttCutoffs[1] << "/" << d.ttCutoffs[2] << "\n";
+    }
+
+    for (size_t i = 0; i < depths.size(); i++) {
+        const DepthStats& d = depths[i];
+        out << "stats depth=" << (i + 1) << " nodes=" << d.nodes << " qnodes=" << d.qnodes
+            << " beta_cutoffs=" << d.betaCutoffs << " first_move_cutoffs=" << d.firstMoveCutoffs
+            << " tt_exact=" << d.ttCutoffs[0] << " tt_lower=" << d.ttCutoffs[1] << " tt_upper=" << d.ttCutoffs[2]
+            << " rfp=" << d.reverseFutility << " razor=" << d.razoring << " futility=" << d.futilityPrunes
+            << " probcut=" << d.probCuts << " singular=" << d.singularExtensions << " multicut=" << d.multiCuts
+            << " check_ext=" << d.checkExtensions << " iir=" << d.iirReductions
+            << " delta=" << d.deltaPrunes << " see=" << d.seePrunes
+            << " evals=" << d.evaluations << " eval_cache_hits=" << d.evalCacheHits
+            << " pawn_table_hits=" << d.pawnTableHits << " lazy_evals=" << d.lazyEvals << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -9,6 +9,8 @@ uint64_t Zobrist::pieceSquare[2][6][64];
 uint64_t Zobrist::sideToMove;
 uint64_t Zobrist::castling[16];
 uint64_t Zobrist::enPassant[8];
+uint64_t Zobrist::exclusion;
+uint64_t Zobrist::material[2][6][MAX_COUNT + 1];
 
 void Zobrist::init() {
     std::mt19937_64 rng(31415926);
@@ -21,5 +23,11 @@ void Zobrist::init() {
     sideToMove = rng();
     for (auto & i : castling) i = rng();
     for (auto & i : enPassant) i = rng();
+    exclusion = rng();
+    // Drawn last so the position keys above keep their values
+    for (auto & color : material)
+        for (auto & piece : color)
+            for (auto & count : piece)
+                count = rng();
 }
 
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <bit>
+#include "board/board.h"
+#include "eval/attacks.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+class AttackMapsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+
+    // Board square index from algebraic notation: a8 is 0, h1 is 63
+    static int sq(const char* name) { return ('8' - name[1]) * 8 + (name[0] - 'a'); }
+    static uint64_t bb(const char* name) { return uint64_t{1} << sq(name); }
+};
+
+TEST_F(AttackMapsTest, KnightAndKingAttacksStopAtTheEdge) {
+    EXPECT_EQ(AttackMaps::knightAttacks(sq("a8")), bb("b6") | bb("c7"));
+    EXPECT_EQ(std::popcount(AttackMaps::knightAttacks(sq("d4"))), 8);
+    EXPECT_EQ(AttackMaps::kingAttacks(sq("h1")), bb("g1") | bb("g2") | bb("h2"));
+    EXPECT_EQ(std::popcount(AttackMaps::kingAttacks(sq("e4"))), 8);
+}
+
+TEST_F(AttackMapsTest, SlidersIncludeTheFirstBlocker) {
+    const uint64_t blockers = bb("d6") | bb("c3") | bb("f2");
+    const uint64_t rook = AttackMaps::rookAttacks(sq("d4"), blockers);
+    EXPECT_EQ(std::popcount(rook), 12);  // d5, d6, d3 to d1 and the whole fourth rank
+    EXPECT_TRUE(rook & bb("d6"));
+    EXPECT_FALSE(rook & bb("d7"));
+
+    EXPECT_EQ(AttackMaps::bishopAttacks(sq("a1"), blockers), bb("b2") | bb("c3"));
+    EXPECT_EQ(AttackMaps::bishopAttacks(sq("e1"), blockers), bb("d2") | bb("c3") | bb("f2"));
+    EXPECT_EQ(std::popcount(AttackMaps::bishopAttacks(sq("a1"), 0)), 7);
+}
+
+TEST_F(AttackMapsTest, BuildsPerSideMaps) {
+    Board board("4k3/8/8/3n4/4P3/8/P7/3RK3 w - - 0 1");
+    const AttackMaps maps(board);
+    EXPECT_EQ(maps.pawnAttacks[0], bb("d5") | bb("f5") | bb("b3"));
+    EXPECT_EQ(maps.byKind[1][1], bb("d5"));
+    EXPECT_EQ(maps.byColor[0], bb("e4") | bb("a2") | bb("d1") | bb("e1"));
+    EXPECT_EQ(maps.occupied, maps.byColor[0] | maps.byColor[1]);
+    EXPECT_EQ(maps.pieceCount, 2);  // The rook and the knight
+
+    // d5 is hit by both the e4 pawn and the rook up the open d-file
+    EXPECT_TRUE(maps.attacks[0] & bb("d5"));
+    EXPECT_TRUE(maps.attackedTwice[0] & bb("d5"));
+    EXPECT_TRUE(maps.attacks[1] & bb("e3"));
+    EXPECT_FALSE(maps.attackedTwice[1] & bb("e3"));
+}
+
+TEST_F(AttackMapsTest, HangingPieceCostsItsOwner) {
+    // The knight on d5 stands on the rook's file with nothing defending it; on c5 it is out of reach
+    Board hanging("r3k3/p7/8/3n4/8/8/P7/3RK3 w - - 0 1");
+    Board safe("r3k3/p7/8/2n5/8/8/P7/3RK3 w - - 0 1");
+    EXPECT_GT(Search::evaluate(hanging), Search::evaluate(safe));
+}
+
+TEST_F(AttackMapsTest, PawnThreatCostsItsOwner) {
+    // Same pawns; only the knight moves into the e4 pawn's reach
+    Board threatened("r3k3/p7/8/5n2/4P3/8/P7/3RK3 w - - 0 1");
+    Board safe("r3k3/p7/8/8/4P3/7n/P7/3RK3 w - - 0 1");
+    EXPECT_GT(Search::evaluate(threatened), Search::evaluate(safe));
+}
+
+TEST_F(AttackMapsTest, KingDangerNeedsTwoAttackers) {
+    // Queen and knight bearing on the castled king, against the same pieces pointed elsewhere
+    Board attacked("r1b2rk1/pppp1ppp/8/4p1NQ/8/8/PPPP1PPP/R1B1K2R w KQ - 0 1");
+    Board quiet("r1b2rk1/pppp1ppp/8/4p3/8/2N2Q2/PPPP1PPP/R1B1K2R w KQ - 0 1");
+    EXPECT_GT(Search::evaluate(attacked), Search::evaluate(quiet));
+}
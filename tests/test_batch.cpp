@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "bench/bench.h"
+#include "board/board.h"
+#include "eval/batch.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+class BatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+};
+
+TEST_F(BatchTest, LoadRoundTripsPieces) {
+    const Board original("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 10");
+    PositionBatch batch;
+    batch.add(original);
+    ASSERT_EQ(batch.size(), 1u);
+
+    Board loaded;
+    batch.load(0, loaded);
+    // Placement and side to move survive; castling rights and en passant are not part of the batch
+    const auto placementAndSide = [](const std::string& fen) { return fen.substr(0, fen.find(' ') + 2); };
+    EXPECT_EQ(placementAndSide(loaded.toFEN()), placementAndSide(original.toFEN()));
+    EXPECT_EQ(loaded.getPawnHash(), original.getPawnHash());
+    EXPECT_EQ(loaded.getMaterialHash(), original.getMaterialHash());
+    EXPECT_EQ(loaded.getPstEarly(), original.getPstEarly());
+    EXPECT_EQ(loaded.kingSquare(Color::Black), original.kingSquare(Color::Black));
+}
+
+TEST_F(BatchTest, OverlappingPiecesThrow) {
+    uint64_t position[2][6] = {};
+    position[0][5] = uint64_t{1} << 60;
+    position[1][5] = uint64_t{1} << 4;
+    position[1][4] = uint64_t{1} << 60;
+    Board board;
+    EXPECT_THROW(board.loadPieces(position, Color::White), std::invalid_argument);
+}
+
+TEST_F(BatchTest, PositionsWithoutOneKingEachOrWithBackRankPawnsThrow) {
+    uint64_t blackOnly[2][6] = {};
+    blackOnly[1][5] = uint64_t{1} << 4;
+    blackOnly[1][0] = uint64_t{1} << 12;
+    uint64_t twoKings[2][6] = {};
+    twoKings[0][5] = uint64_t{1} << 60 | uint64_t{1} << 62;
+    twoKings[1][5] = uint64_t{1} << 4;
+    uint64_t backRankPawn[2][6] = {};
+    backRankPawn[0][5] = uint64_t{1} << 60;
+    backRankPawn[1][5] = uint64_t{1} << 4;
+    backRankPawn[0][0] = uint64_t{1} << 56;
+
+    Board board;
+    PositionBatch batch;
+    for (const auto* position : {&blackOnly, &twoKings, &backRankPawn}) {
+        EXPECT_THROW(board.loadPieces(*position, Color::White), std::invalid_argument);
+        EXPECT_THROW(batch.add(*position, Color::White), std::invalid_argument);
+    }
+    EXPECT_EQ(batch.size(), 0u);
+
+    // A black king and pawn alone used to reach the KPK bitbase with no white king
+    batch.add(Board());
+    for (int piece = 0; piece < 6; piece++) {
+        batch.pieces[0][piece][0] = blackOnly[0][piece];
+        batch.pieces[1][piece][0] = blackOnly[1][piece];
+    }
+    std::vector<int> scores(batch.size());
+    EXPECT_THROW(BatchEvaluator::evaluate(batch, scores, 1), std::invalid_argument);
+}
+
+TEST_F(BatchTest, InvalidPositionsThrowToTheCaller) {
+    uint64_t position[2][6] = {};
+    position[0][5] = uint64_t{1} << 60;
+    position[1][5] = uint64_t{1} << 60;
+    PositionBatch batch;
+    EXPECT_THROW(batch.add(position, Color::White), std::invalid_argument);
+    EXPECT_EQ(batch.size(), 0u);
+
+    // Edited in place past add's check: the worker's error reaches the caller instead of terminating
+    for (int i = 0; i < 3000; i++) batch.add(Board());
+    batch.pieces[1][4][2500] = batch.pieces[0][4][2500];
+    std::vector<int> scores(batch.size());
+    for (const int threads : {1, 4}) {
+        EXPECT_THROW(BatchEvaluator::evaluate(batch, scores, threads), std::invalid_argument) << threads;
+    }
+}
+
+TEST_F(BatchTest, MatchesSingleEvaluationOnEveryThreadCount) {
+    PositionBatch batch;
+    std::vector<int> expected;
+    // Enough copies of the bench suite to span several chunks
+    for (int copy = 0; copy < 60; copy++) {
+        for (const std::string& fen : Bench::positions()) {
+            Board board(fen);
+            batch.add(board);
+            if (copy == 0) expected.push_back(Search::evaluate(board));
+        }
+    }
+    ASSERT_GT(batch.size(), 2 * BatchEvaluator::CHUNK);
+
+    for (const int threads : {1, 4}) {
+        std::vector<int> scores(batch.size());
+        BatchEvaluator::evaluate(batch, scores, threads);
+        for (size_t i = 0; i < scores.size(); i++) {
+            ASSERT_EQ(scores[i], expected[i % expected.size()]) << "position " << i << " threads " << threads;
+        }
+    }
+}
+
+TEST_F(BatchTest, ScoreSpanMustMatch) {
+    PositionBatch batch;
+    batch.add(Board());
+    std::vector<int> scores(2);
+    EXPECT_THROW(BatchEvaluator::evaluate(batch, scores), std::invalid_argument);
+
+    batch.clear();
+    scores.clear();
+    EXPECT_NO_THROW(BatchEvaluator::evaluate(batch, scores));
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "bench/bench.h"
+#include "board/board.h"
+#include "search/zobrist.h"
+
+class BenchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+};
+
+TEST_F(BenchTest, PositionsAreLegal) {
+    // The side that just moved must not be left in check, and both kings must be on the board
+    for (const std::string& fen : Bench::positions()) {
+        Board board(fen);
+        const Color moved = board.getColor() == Color::White ? Color::Black : Color::White;
+        EXPECT_NE(board.kingSquare(Color::White).r, -1) << fen;
+        EXPECT_NE(board.kingSquare(Color::Black).r, -1) << fen;
+        EXPECT_FALSE(board.isChecked(moved)) << fen;
+    }
+}
+
+TEST_F(BenchTest, SignatureIndependentOfThreads) {
+    std::ostringstream single, multi;
+    const BenchResult one = Bench::run(2, 1, 1, single);
+    const BenchResult many = Bench::run(2, 3, 1, multi);
+    EXPECT_GT(one.nodes, 0u);
+    EXPECT_EQ(one.nodes, many.nodes);
+    // Per-position lines are reported in suite order either way
+    EXPECT_EQ(single.str().substr(0, single.str().find("====")), multi.str().substr(0, multi.str().find("====")));
+}
+
+TEST_F(BenchTest, PrintsMachineReadableSummary) {
+    std::ostringstream out;
+    const BenchResult result = Bench::run(1, 1, 1, out);
+    EXPECT_NE(out.str().find("bench depth=1 threads=1 hash=1 positions=50 nodes=" + std::to_string(result.nodes)),
+              std::string::npos);
+}
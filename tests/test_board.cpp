@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "board/board.h"
+#include "generator/generator.h"
+#include "search/zobrist.h"
 
 TEST(BoardTest, DefaultConstructorStartingPosition) {
     Board board;
@@ -41,4 +43,88 @@ TEST(BoardTest, ParseUCIInvalidThrows) {
     EXPECT_THROW(board.parseUCI("e2"), std::invalid_argument);
     EXPECT_THROW(board.parseUCI("i2e4"), std::invalid_argument);
     EXPECT_THROW(board.parseUCI("e9e4"), std::invalid_argument);
-}
\ No newline at end of file
+}
+
+// givesCheck must agree with actually playing the move for every pseudo-legal move
+static void expectGivesCheckMatchesMakeMove(const std::string& fen) {
+    Board board(fen);
+    const Color enemy = board.getColor() == Color::White ? Color::Black : Color::White;
+    for (const Move& move : Generator::generatePseudoMoves(board)) {
+        const bool predicted = board.givesCheck(move);
+        MoveUndo undo = board.makeMove(move, false);
+        EXPECT_EQ(predicted, board.isChecked(enemy)) << fen << " " << Board::toUCI(move);
+        board.undoMove(undo);
+    }
+}
+
+TEST(BoardTest, GivesCheckDirect) {
+    expectGivesCheckMatchesMakeMove("4k3/8/8/8/8/8/8/R2QKB1N w - - 0 1");
+    expectGivesCheckMatchesMakeMove("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4");
+}
+
+TEST(BoardTest, GivesCheckDiscovered) {
+    // Knight, bishop and king all unmask a slider
+    expectGivesCheckMatchesMakeMove("4k3/8/8/4N3/8/8/8/4R1K1 w - - 0 1");
+    expectGivesCheckMatchesMakeMove("7k/8/8/8/3N4/8/8/Q6K w - - 0 1");
+    expectGivesCheckMatchesMakeMove("k7/8/8/3K4/8/8/8/7B w - - 0 1");
+}
+
+TEST(BoardTest, GivesCheckSpecialMoves) {
+    // Promotions, en passant discovering a rook, castling into check
+    expectGivesCheckMatchesMakeMove("3k4/1P6/8/8/8/8/8/4K3 w - - 0 1");
+    expectGivesCheckMatchesMakeMove("8/8/8/K2pP2k/8/8/8/8 w - d6 0 1");
+    expectGivesCheckMatchesMakeMove("5k2/8/8/8/8/8/8/4K2R w K - 0 1");
+    expectGivesCheckMatchesMakeMove("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+}
+
+TEST(BoardTest, KingSquareTrackedThroughMoves) {
+    Board board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    MoveUndo castle = board.makeMove(Move(Square(7, 4), Square(7, 6), MoveType::Castle), false);
+    EXPECT_EQ(board.kingSquare(Color::White).r, 7);
+    EXPECT_EQ(board.kingSquare(Color::White).c, 6);
+    board.undoMove(castle);
+    EXPECT_EQ(board.kingSquare(Color::White).c, 4);
+    EXPECT_EQ(board.kingSquare(Color::Black).r, 0);
+    EXPECT_EQ(board.kingSquare(Color::Black).c, 4);
+}
+
+TEST(BoardTest, StaticExchangeEvaluation) {
+    // Pawn takes undefended knight
+    Board free("4k3/8/8/3n4/4P3/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(free.see(Move(Square(4, 4), Square(3, 3))), 320);
+
+    // Queen takes a pawn defended by a pawn: loses the queen for a pawn
+    Board defended("4k3/8/2p5/3p4/8/8/3Q4/4K3 w - - 0 1");
+    EXPECT_EQ(defended.see(Move(Square(6, 3), Square(3, 3))), 100 - 900);
+
+    // Rook x rook with a second rook behind (x-ray) against a single defender wins the exchange back
+    Board battery("3rk3/8/8/3r4/8/8/3R4/3RK3 w - - 0 1");
+    EXPECT_EQ(battery.see(Move(Square(6, 3), Square(3, 3))), 500);
+
+    // Quiet move onto an attacked square hangs the piece
+    Board hanging("4k3/8/8/2p5/8/8/8/1N2K3 w - - 0 1");
+    EXPECT_EQ(hanging.see(Move(Square(7, 1), Square(4, 1))), -320);
+}
+
+TEST(BoardTest, IncrementalEvalTermsMatchRecomputed) {
+    Zobrist::init();
+    // Castling, en passant, a capture and a promotion, each compared with a board built from the resulting FEN
+    Board board("r3k2r/1P3ppp/8/3pP3/8/8/P4PPP/R3K2R w KQkq d6 0 1");
+    const int material = board.getMaterialScore();
+    const int early = board.getPstEarly();
+    const int late = board.getPstLate();
+
+    std::vector<MoveUndo> undos;
+    for (const char* uci : {"e5d6", "e8g8", "e1c1", "a8a2", "b7b8q"}) {
+        undos.push_back(board.makeMove(board.parseUCI(uci).value(), false));
+        Board fresh(board.toFEN());
+        EXPECT_EQ(board.getMaterialScore(), fresh.getMaterialScore()) << uci;
+        EXPECT_EQ(board.getPstEarly(), fresh.getPstEarly()) << uci;
+        EXPECT_EQ(board.getPstLate(), fresh.getPstLate()) << uci;
+    }
+
+    for (auto it = undos.rbegin(); it != undos.rend(); ++it) board.undoMove(*it);
+    EXPECT_EQ(board.getMaterialScore(), material);
+    EXPECT_EQ(board.getPstEarly(), early);
+    EXPECT_EQ(board.getPstLate(), late);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "board/board.h"
+#include "eval/endgame.h"
+#include "eval/kpk.h"
+#include "eval/material.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+class EndgameTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+};
+
+TEST_F(EndgameTest, MaterialHashTracksCapturesAndPromotions) {
+    Board board("r3k2r/1P3ppp/8/3pP3/8/8/P4PPP/R3K1NR w KQkq d6 0 1");
+    const uint64_t original = board.getMaterialHash();
+
+    std::vector<MoveUndo> undos;
+    for (const char* uci : {"e5d6", "a8a2", "g1f3", "b7b8q"}) {
+        undos.push_back(board.makeMove(board.parseUCI(uci).value(), false));
+        Board fresh(board.toFEN());
+        EXPECT_EQ(board.getMaterialHash(), fresh.getMaterialHash()) << uci;
+        EXPECT_EQ(board.pieceCount(Color::White, PieceKind::Pawn), fresh.pieceCount(Color::White, PieceKind::Pawn)) << uci;
+    }
+    EXPECT_EQ(board.pieceCount(Color::White, PieceKind::Queen), 1);
+
+    for (auto it = undos.rbegin(); it != undos.rend(); ++it) board.undoMove(*it);
+    EXPECT_EQ(board.getMaterialHash(), original);
+    EXPECT_EQ(board.pieceCount(Color::White, PieceKind::Pawn), 6);
+    EXPECT_EQ(board.pieceCount(Color::Black, PieceKind::Pawn), 4);
+}
+
+TEST_F(EndgameTest, MaterialHashIgnoresPlacement) {
+    Board board1("4k3/8/8/3n4/8/8/2R5/4K3 w - - 0 1");
+    Board board2("8/2k5/5n2/8/8/8/8/R3K3 b - - 0 1");
+    EXPECT_EQ(board1.getMaterialHash(), board2.getMaterialHash());
+    EXPECT_NE(board1.getHash(), board2.getHash());
+}
+
+TEST_F(EndgameTest, InsufficientMaterialIsDeadDraw) {
+    for (const char* fen : {"4k3/8/8/8/8/8/8/4K3 w - - 0 1", "4k3/8/8/8/8/8/8/4KN2 w - - 0 1",
+                            "4k3/8/2b5/8/8/8/8/4K3 b - - 0 1"}) {
+        Board board(fen);
+        EXPECT_TRUE(MaterialTable::compute(board).deadDraw) << fen;
+        EXPECT_EQ(Search::evaluate(board), 0) << fen;
+    }
+    Board knights("4k3/8/8/8/8/8/8/2N1KN2 w - - 0 1");
+    EXPECT_FALSE(MaterialTable::compute(knights).deadDraw);
+    EXPECT_EQ(Search::evaluate(knights), 0);  // Two knights can't force mate
+}
+
+TEST_F(EndgameTest, MaterialEntryPhaseAndBishopPair) {
+    Board board;
+    const MaterialEntry entry = MaterialTable::compute(board);
+    EXPECT_EQ(entry.phase, MAX_PHASE);
+    EXPECT_EQ(entry.imbalance, 0);
+
+    Board pair("4k3/8/8/8/8/8/8/2B1KB2 w - - 0 1");
+    EXPECT_EQ(MaterialTable::compute(pair).imbalance, MaterialTable::BISHOP_PAIR);
+}
+
+TEST_F(EndgameTest, KPKBitbase) {
+    // Squares with a1 = 0: e1 = 4, e2 = 12, e3 = 20
+    EXPECT_FALSE(KPK::probe(true, 4, 12, 20));
+    // King in front of its pawn on the sixth rank wins whoever moves: Ke6, Pe5, ke8
+    EXPECT_TRUE(KPK::probe(true, 44, 36, 60));
+    EXPECT_TRUE(KPK::probe(false, 44, 36, 60));
+    // Rook pawn with the defending king in the corner: Ka6, Pa5, ka8
+    EXPECT_FALSE(KPK::probe(true, 40, 32, 56));
+}
+
+TEST_F(EndgameTest, KPKEvaluationForEitherColour) {
+    Board whiteWins("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1");
+    EXPECT_GT(Search::evaluate(whiteWins), Endgame::KNOWN_WIN);
+
+    Board blackWins("8/8/8/8/4p3/4k3/8/4K3 w - - 0 1");
+    EXPECT_LT(Search::evaluate(blackWins), -Endgame::KNOWN_WIN);
+
+    Board drawn("8/8/8/8/8/4k3/4P3/4K3 w - - 0 1");
+    EXPECT_EQ(Search::evaluate(drawn), 0);
+}
+
+TEST_F(EndgameTest, KPKIgnoresPositionsOutsideTheBitbase) {
+    // Hand-set-up boards only: a pawn on a back rank, or a side without its king
+    Board backRank("4k3/8/8/8/8/8/8/P3K3 w - - 0 1");
+    EXPECT_EQ(Endgame::kpk(backRank, Color::White), 0);
+
+    Board noWhiteKing("4k3/8/8/8/8/8/4p3/8 w - - 0 1");
+    EXPECT_EQ(Endgame::kpk(noWhiteKing, Color::Black), 0);
+    EXPECT_EQ(Search::evaluate(noWhiteKing), 0);
+}
+
+TEST_F(EndgameTest, KXKDrivesKingToEdge) {
+    Board edge("7k/8/8/8/8/8/8/R3K3 w - - 0 1");
+    Board centre("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+    EXPECT_GT(Search::evaluate(edge), Endgame::KNOWN_WIN);
+    EXPECT_GT(Search::evaluate(edge), Search::evaluate(centre));
+
+    Board blackQueen("4k3/8/8/8/8/8/8/q6K w - - 0 1");
+    EXPECT_LT(Search::evaluate(blackQueen), -Endgame::KNOWN_WIN);
+}
+
+TEST_F(EndgameTest, KBNKPrefersBishopCorner) {
+    // Dark-squared bishop on c1: mate happens in a1 or h8, not h1
+    Board rightCorner("8/8/8/8/8/8/5K2/k1B2N2 w - - 0 1");
+    Board wrongCorner("8/8/8/8/8/8/2K5/2B2N1k w - - 0 1");
+    EXPECT_GT(Search::evaluate(rightCorner), Search::evaluate(wrongCorner));
+    EXPECT_GT(Search::evaluate(wrongCorner), Endgame::KNOWN_WIN);
+}
+
+TEST_F(EndgameTest, DeadDrawSubtreesAreCut) {
+    // Once the last pawn falls only a bishop is left, and every such node returns at once
+    Search search(16);
+    search.setInfoOutput(false);
+    Board board("8/8/4k3/8/8/2B1p3/8/4K3 w - - 0 1");
+    search.findBestMove(board, 6);
+    const uint64_t withPawn = search.getNodes();
+
+    Board bare("8/8/4k3/8/8/2B5/8/4K3 w - - 0 1");
+    search.clearTT();
+    search.findBestMove(bare, 6);
+    EXPECT_LT(search.getNodes(), 100u);
+    EXPECT_GT(withPawn, search.getNodes());
+}
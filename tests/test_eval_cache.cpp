@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "board/board.h"
+#include "search/eval_cache.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+class EvalCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+};
+
+TEST_F(EvalCacheTest, StoreAndProbe) {
+    EvalCache cache(1024);
+    int score = 0;
+    EXPECT_FALSE(cache.probe(0x123456789ABCDEF0, score));
+
+    cache.store(0x123456789ABCDEF0, -42);
+    ASSERT_TRUE(cache.probe(0x123456789ABCDEF0, score));
+    EXPECT_EQ(score, -42);
+    EXPECT_EQ(cache.hits, 1u);
+    EXPECT_EQ(cache.misses, 1u);
+}
+
+TEST_F(EvalCacheTest, SameSlotIsOverwritten) {
+    EvalCache cache(1024);
+    const uint64_t first = 0x1000;
+    const uint64_t second = first + 1024;  // Same slot in a 1024-entry table
+    cache.store(first, 10);
+    cache.store(second, 20);
+
+    int score = 0;
+    EXPECT_FALSE(cache.probe(first, score));
+    ASSERT_TRUE(cache.probe(second, score));
+    EXPECT_EQ(score, 20);
+}
+
+TEST_F(EvalCacheTest, ClearedTableMissesHashZero) {
+    EvalCache cache(1024);
+    int score = 0;
+    EXPECT_FALSE(cache.probe(0, score));
+    cache.store(0x2000, 5);
+    cache.clear();
+    EXPECT_FALSE(cache.probe(0x2000, score));
+}
+
+TEST_F(EvalCacheTest, HashZeroIsNeverStored) {
+    EvalCache cache(1024);
+    cache.store(0x400, 7);  // Slot 0 of a 1024-entry table
+    cache.store(0, 9);
+
+    int score = 0;
+    ASSERT_TRUE(cache.probe(0x400, score));
+    EXPECT_EQ(score, 7);
+    EXPECT_FALSE(cache.probe(0, score));
+}
+
+TEST_F(EvalCacheTest, SearchReusesEvaluations) {
+    Search search(16);
+    search.setInfoOutput(false);
+    Board board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    search.findBestMove(board, 4);
+
+    uint64_t evaluations = 0;
+    uint64_t hits = 0;
+    for (const DepthStats& d : search.getStats().depths) {
+        evaluations += d.evaluations;
+        hits += d.evalCacheHits;
+    }
+    EXPECT_GT(evaluations, 0u);
+    EXPECT_GT(hits, 0u);
+    EXPECT_LT(hits, evaluations);
+}
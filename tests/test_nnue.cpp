@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "board/board.h"
+#include "eval/nnue.h"
+#include "eval/simd.h"
+#include "generator/generator.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+class NnueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+    void TearDown() override {
+        Simd::setLevel(Simd::detect());
+    }
+
+    static const NnueNetwork& network() {
+        static const std::shared_ptr<NnueNetwork> net = NnueNetwork::random(7);
+        return *net;
+    }
+};
+
+TEST_F(NnueTest, FeaturesMirrorBetweenPerspectives) {
+    // A white knight on c3 with the white king on g1, seen by white, is black's view of the mirrored position
+    const int c3 = 5 * 8 + 2, c6 = 2 * 8 + 2, g1 = 7 * 8 + 6, g8 = 6;
+    EXPECT_EQ(NnueArch::feature(0, g1, 1, 0, c3), NnueArch::feature(1, g8, 1, 1, c6));
+    EXPECT_NE(NnueArch::feature(0, g1, 1, 0, c3), NnueArch::feature(0, g1, 1, 1, c3));
+    EXPECT_LT(NnueArch::feature(1, 0, 4, 0, 63), NnueArch::INPUTS);
+}
+
+TEST_F(NnueTest, IncrementalAccumulatorsMatchRefresh) {
+    // Castling, en passant, captures, promotion and king moves, each followed by an evaluation and later undone
+    Board board("r3k2r/1P3ppp/8/3pP3/8/8/5PPP/R3K2R w KQkq d6 0 1");
+    NnueAccumulators accumulators;
+    accumulators.reset();
+    board.attachAccumulators(&accumulators);
+    EXPECT_EQ(network().evaluate(board, accumulators), network().evaluate(board));
+
+    std::vector<MoveUndo> undos;
+    for (const char* uci : {"e5d6", "e8c8", "b7a8q", "d8d6", "e1g1", "d6d2", "a8a7", "h7h5"}) {
+        const auto move = board.parseUCI(uci);
+        ASSERT_TRUE(move.has_value()) << uci;
+        undos.push_back(board.makeMove(*move, false));
+        EXPECT_EQ(network().evaluate(board, accumulators), network().evaluate(board)) << uci;
+    }
+    // Unwinding restores the earlier plies' sums without recomputing them
+    while (!undos.empty()) {
+        board.undoMove(undos.back());
+        undos.pop_back();
+        EXPECT_EQ(network().evaluate(board, accumulators), network().evaluate(board)) << undos.size();
+    }
+    EXPECT_EQ(accumulators.size(), 1);
+    board.attachAccumulators(nullptr);
+}
+
+TEST_F(NnueTest, CopiesStartDetached) {
+    Board board;
+    NnueAccumulators accumulators;
+    board.attachAccumulators(&accumulators);
+    const Board copy = board;
+    EXPECT_EQ(copy.getAccumulators(), nullptr);
+    board.attachAccumulators(nullptr);
+}
+
+TEST_F(NnueTest, ScalarAndAvx2Agree) {
+    Board board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    Simd::setLevel(Simd::Level::Scalar);
+    const int scalar = network().evaluate(board);
+    Simd::setLevel(Simd::detect());
+    EXPECT_EQ(network().evaluate(board), scalar);
+}
+
+TEST_F(NnueTest, SaveLoadRoundTrip) {
+    const std::string path = ::testing::TempDir() + "nnue_roundtrip.nnue";
+    network().save(path);
+    const auto loaded = NnueNetwork::load(path);
+    for (const char* fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 10"}) {
+        Board board(fen);
+        EXPECT_EQ(loaded->evaluate(board), network().evaluate(board)) << fen;
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(NnueTest, LoadRejectsBadFiles) {
+    EXPECT_THROW(NnueNetwork::load(::testing::TempDir() + "missing.nnue"), std::runtime_error);
+
+    const std::string path = ::testing::TempDir() + "nnue_bad.nnue";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a network";
+    }
+    EXPECT_THROW(NnueNetwork::load(path), std::runtime_error);
+
+    // Right header, truncated body
+    network().save(path);
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    }
+    EXPECT_THROW(NnueNetwork::load(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_F(NnueTest, SearchUsesNetworkWhenEnabled) {
+    Search search(16);
+    search.setInfoOutput(false);
+    Board board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    const std::string fen = board.toFEN();
+
+    search.setUseNnue(true);
+    EXPECT_FALSE(search.nnueActive());  // No network yet
+    search.setNetwork(NnueNetwork::random(7));
+    EXPECT_TRUE(search.nnueActive());
+
+    const Move best = search.findBestMove(board, 4);
+    EXPECT_EQ(board.toFEN(), fen);
+    EXPECT_EQ(board.getAccumulators(), nullptr);
+    const std::vector<Move> moves = Generator::generatePseudoMoves(board);
+    EXPECT_NE(std::find(moves.begin(), moves.end(), best), moves.end());
+}
+
+TEST_F(NnueTest, SwitchingEvaluationClearsTheTT) {
+    Search search(16);
+    search.setInfoOutput(false);
+    const Board board;
+    // The root itself isn't stored; the position after the best move is
+    auto searchAndFindChild = [&search, &board] {
+        Board root = board;
+        Board child = board;
+        child.makeMove(search.findBestMove(root, 3), false);
+        return child.getHash();
+    };
+
+    const uint64_t first = searchAndFindChild();
+    ASSERT_NE(search.probeTT(first), nullptr);
+    search.setNetwork(NnueNetwork::random(7));
+    EXPECT_EQ(search.probeTT(first), nullptr);
+
+    const uint64_t second = searchAndFindChild();
+    ASSERT_NE(search.probeTT(second), nullptr);
+    search.setUseNnue(true);
+    EXPECT_EQ(search.probeTT(second), nullptr);
+}
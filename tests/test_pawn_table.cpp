@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "board/board.h"
+#include "eval/pawn_table.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+class PawnTableTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+};
+
+TEST_F(PawnTableTest, PassedPawnsScoreByRank) {
+    // Both pawns are passed: white a6 five ranks from home, black h7 still on its starting square
+    Board board("4k3/7p/P7/8/8/8/8/4K3 w - - 0 1");
+    const PawnEntry entry = PawnTable::compute(board);
+    const int white = pawnPST[2][0] + 10 + 5 * 15;
+    const int black = pawnPST[6][7] + 10 + 1 * 15;
+    EXPECT_EQ(entry.score, white - black);
+}
+
+TEST_F(PawnTableTest, ShieldCountsPerWing) {
+    Board board("r3k2r/ppp2p1p/6p1/8/8/7P/P1P2PP1/R3K2R w KQkq - 0 1");
+    const PawnEntry entry = PawnTable::compute(board);
+    EXPECT_EQ(entry.shield[0][PawnEntry::Kingside], 3);   // f2, g2 and h3
+    EXPECT_EQ(entry.shield[0][PawnEntry::Queenside], 2);  // a2 and c2
+    EXPECT_EQ(entry.shield[1][PawnEntry::Kingside], 2);   // f7 and h7; g6 is not counted
+    EXPECT_EQ(entry.shield[1][PawnEntry::Queenside], 3);
+}
+
+TEST_F(PawnTableTest, ProbeHitsAfterFirstMiss) {
+    PawnTable table(1024);
+    Board board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    const PawnEntry& first = table.probe(board);
+    EXPECT_EQ(table.misses, 1u);
+    EXPECT_EQ(first.key, board.getPawnHash());
+
+    // A knight move leaves the pawns, and so the entry, unchanged
+    board.makeMove(board.parseUCI("b1c3").value(), false);
+    const PawnEntry& second = table.probe(board);
+    EXPECT_EQ(table.hits, 1u);
+    EXPECT_EQ(second.score, PawnTable::compute(board).score);
+}
+
+TEST_F(PawnTableTest, EvaluationMatchesWithAndWithoutTable) {
+    PawnTable table;
+    for (const char* fen : {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+            "2kr3r/ppp2ppp/8/8/8/8/PPP2PPP/1K1R3R w - - 0 1",
+            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11"}) {
+        Board board(fen);
+        EXPECT_EQ(Search::evaluate(board, &table), Search::evaluate(board)) << fen;
+        EXPECT_EQ(Search::evaluate(board, &table), Search::evaluate(board)) << fen;  // Now from the table
+    }
+    EXPECT_GT(table.hits, 0u);
+}
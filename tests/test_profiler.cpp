@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include "profiler.h"
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Profiler::reset();
+    }
+};
+
+TEST_F(ProfilerTest, NestedZonesRecordSelfTime) {
+    {
+        ScopedZone outer(ProfileZone::AlphaBeta);
+        for (int i = 0; i < 3; i++) {
+            ScopedZone inner(ProfileZone::Evaluate);
+        }
+    }
+    EXPECT_EQ(Profiler::calls(ProfileZone::AlphaBeta), 1u);
+    EXPECT_EQ(Profiler::calls(ProfileZone::Evaluate), 3u);
+}
+
+TEST_F(ProfilerTest, AggregatesExitedThreads) {
+    auto work = [] {
+        for (int i = 0; i < 100; i++) ScopedZone zone(ProfileZone::See);
+    };
+    std::thread a(work), b(work);
+    a.join();
+    b.join();
+    work();
+    EXPECT_EQ(Profiler::calls(ProfileZone::See), 300u);
+
+    std::ostringstream out;
+    Profiler::print(out);
+    EXPECT_NE(out.str().find("see : "), std::string::npos);
+    EXPECT_NE(out.str().find("calls=300"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, ResetClearsCounters) {
+    { ScopedZone zone(ProfileZone::MakeMove); }
+    Profiler::reset();
+    EXPECT_EQ(Profiler::calls(ProfileZone::MakeMove), 0u);
+}
+
+TEST_F(ProfilerTest, PerfCountersReadZeroWhenUnavailable) {
+    PerfCounters counters;
+    const PerfCounters::Values first = counters.read();
+    volatile uint64_t sink = 0;
+    for (int i = 0; i < 100000; i++) sink = sink + i;
+    const PerfCounters::Values second = counters.read();
+
+    for (size_t e = 0; e < PerfCounters::EVENTS; e++) {
+        if (!counters.available(static_cast<PerfEvent>(e))) {
+            EXPECT_EQ(second[e], 0u);
+        }
+    }
+    // Instructions are the one event every PMU has; where it opens, the loop above must register
+    if (counters.available(PerfEvent::Instructions)) {
+        EXPECT_GT(second[static_cast<size_t>(PerfEvent::Instructions)], first[static_cast<size_t>(PerfEvent::Instructions)]);
+    }
+}
+
+TEST_F(ProfilerTest, TraceExportsBalancedTimeline) {
+    Profiler::enableTrace(true);
+    {
+        ScopedZone outer(ProfileZone::AlphaBeta);
+        { ScopedZone inner(ProfileZone::Quiescence); }
+    }
+    std::thread([] { ScopedZone zone(ProfileZone::Evaluate); }).join();
+    Profiler::enableTrace(false);
+
+    std::ostringstream chrome, folded;
+    Profiler::writeTrace(chrome, folded);
+    const std::string json = chrome.str();
+
+    auto count = [&](const std::string& needle) {
+        size_t n = 0;
+        for (size_t pos = json.find(needle); pos != std::string::npos; pos = json.find(needle, pos + 1)) n++;
+        return n;
+    };
+    EXPECT_EQ(count("\"ph\":\"B\""), 3u);
+    EXPECT_EQ(count("\"ph\":\"E\""), 3u);
+    EXPECT_NE(json.find("\"name\":\"quiescence\""), std::string::npos);
+
+    EXPECT_NE(folded.str().find("alphaBeta;quiescence "), std::string::npos);
+    EXPECT_NE(folded.str().find("\nevaluate "), std::string::npos);
+}
+
+TEST(TraceWriterTest, DropsUnmatchedEndsAndClosesOpenBegins) {
+    // As if the buffer wrapped mid-span: an end with no begin, then a begin that never ends
+    TraceBuffer buffer(0);
+    buffer.record(100, 0, false);
+    buffer.record(200, 1, true);
+    buffer.record(300, 2, true);
+    buffer.record(400, 2, false);
+    const char* names[] = {"a", "b", "c"};
+
+    std::ostringstream chrome, folded;
+    TraceWriter::writeChrome({&buffer}, names, 1.0, chrome);
+    TraceWriter::writeFolded({&buffer}, names, 1.0, folded);
+    EXPECT_EQ(chrome.str().find("\"name\":\"a\""), std::string::npos);
+    EXPECT_EQ(folded.str(), "b 100000\nb;c 100000\n");
+}
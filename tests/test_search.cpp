@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
 #include "board/board.h"
 #include "search/search.h"
 #include "generator/generator.h"
@@ -118,10 +120,12 @@ TEST_F(SearchTest, DeeperSearchFindsMateFaster) {
     EXPECT_EQ(depth2.destination.c, depth4.destination.c);
 }
 
+// The positions in these term tests keep a locked pair of a-pawns so the generic evaluation scores them rather
+// than an endgame evaluator
 TEST_F(SearchTest, KnightOnRimIsDim) {
     // Knight on h4 vs knight on e4 - central knight should be better
-    Board board_rim("4k3/8/8/8/7N/8/8/4K3 w - - 0 1");
-    Board board_center("4k3/8/8/8/4N3/8/8/4K3 w - - 0 1");
+    Board board_rim("4k3/p7/8/8/7N/8/P7/4K3 w - - 0 1");
+    Board board_center("4k3/p7/8/8/4N3/8/P7/4K3 w - - 0 1");
 
     int score_rim = Search::evaluate(board_rim);
     int score_center = Search::evaluate(board_center);
@@ -130,8 +134,8 @@ TEST_F(SearchTest, KnightOnRimIsDim) {
 }
 
 TEST_F(SearchTest, KnightInCornerWorst) {
-    Board board_corner("4k3/8/8/8/8/8/8/N3K3 w - - 0 1");
-    Board board_edge("4k3/8/8/8/8/8/8/1N2K3 w - - 0 1");
+    Board board_corner("4k3/p7/8/8/8/8/P7/N3K3 w - - 0 1");
+    Board board_edge("4k3/p7/8/8/8/8/P7/1N2K3 w - - 0 1");
 
     int score_corner = Search::evaluate(board_corner);
     int score_edge = Search::evaluate(board_edge);
@@ -152,8 +156,8 @@ TEST_F(SearchTest, BishopMobilityMatters) {
 
 TEST_F(SearchTest, RookMobilityMatters) {
     // Open rook vs rook blocked by own pieces
-    Board board_open("4k3/8/8/4P3/3R4/8/8/4K3 w - - 0 1");
-    Board board_blocked("4k3/8/8/3P4/3R4/8/8/4K3 w - - 0 1");
+    Board board_open("4k3/p7/8/4P3/3R4/8/P7/4K3 w - - 0 1");
+    Board board_blocked("4k3/p7/8/3P4/3R4/8/P7/4K3 w - - 0 1");
 
     int score_open = Search::evaluate(board_open);
     int score_blocked = Search::evaluate(board_blocked);
@@ -163,9 +167,9 @@ TEST_F(SearchTest, RookMobilityMatters) {
 
 TEST_F(SearchTest, PassedPawnBonus) {
     // White pawn with no enemy pawns ahead or on adjacent files
-    Board board_passed("4k3/8/8/8/3P4/8/8/4K3 w - - 0 1");
+    Board board_passed("4k3/p7/8/8/3P4/8/P7/4K3 w - - 0 1");
     // White pawn blocked by enemy pawn on same file
-    Board board_blocked("4k3/3p4/8/8/3P4/8/8/4K3 w - - 0 1");
+    Board board_blocked("4k3/p2p4/8/8/3P4/8/P7/4K3 w - - 0 1");
 
     int score_passed = Search::evaluate(board_passed);
     int score_blocked = Search::evaluate(board_blocked);
@@ -175,8 +179,8 @@ TEST_F(SearchTest, PassedPawnBonus) {
 
 TEST_F(SearchTest, AdvancedPassedPawnWorthMore) {
     // Passed pawn on rank 6 vs rank 3
-    Board board_advanced("4k3/8/3P4/8/8/8/8/4K3 w - - 0 1");
-    Board board_back("4k3/8/8/8/8/3P4/8/4K3 w - - 0 1");
+    Board board_advanced("4k3/p7/3P4/8/8/8/P7/4K3 w - - 0 1");
+    Board board_back("4k3/p7/8/8/8/3P4/P7/4K3 w - - 0 1");
 
     int score_advanced = Search::evaluate(board_advanced);
     int score_back = Search::evaluate(board_back);
@@ -186,8 +190,8 @@ TEST_F(SearchTest, AdvancedPassedPawnWorthMore) {
 
 TEST_F(SearchTest, PawnBlockedByAdjacentFilePawn) {
     // Pawn with enemy pawn on adjacent file ahead - not a passer
-    Board board_not_passed("4k3/2p5/8/8/3P4/8/8/4K3 w - - 0 1");
-    Board board_passed("4k3/8/8/8/3P4/8/8/4K3 w - - 0 1");
+    Board board_not_passed("4k3/p1p5/8/8/3P4/8/P7/4K3 w - - 0 1");
+    Board board_passed("4k3/p7/8/8/3P4/8/P7/4K3 w - - 0 1");
 
     int score_not_passed = Search::evaluate(board_not_passed);
     int score_passed = Search::evaluate(board_passed);
@@ -208,8 +212,8 @@ TEST_F(SearchTest, KingInCenterBadEarlyGame) {
 
 TEST_F(SearchTest, KingCentralizationGoodEndgame) {
     // King and pawn endgame - central king better
-    Board board_center("4k3/8/8/8/3K4/8/8/8 w - - 0 1");
-    Board board_corner("4k3/8/8/8/8/8/8/K7 w - - 0 1");
+    Board board_center("4k3/p7/8/8/3K4/8/P7/8 w - - 0 1");
+    Board board_corner("4k3/p7/8/8/8/8/P7/K7 w - - 0 1");
 
     int score_center = Search::evaluate(board_center);
     int score_corner = Search::evaluate(board_corner);
@@ -242,4 +246,289 @@ TEST_F(SearchTest, EarlyQueenDevelopmentPunished) {
     int score_home = Search::evaluate(board_home);
 
     EXPECT_GT(score_home, score_aggressive);
-}
\ No newline at end of file
+}
+
+TEST_F(SearchTest, ShallowPruningKeepsTactics) {
+    // Rook hangs to the bishop; static eval is far outside the window at most frontier nodes
+    Board board("4k3/8/8/8/3r4/8/1B6/4K3 w - - 0 1");
+    Move pruned = search.findBestMove(board, 4);
+
+    Search plain;
+    plain.params.reverseFutilityDepth = 0;
+    plain.params.futilityDepth = 0;
+    plain.params.razorDepth = 0;
+    Move unpruned = plain.findBestMove(board, 4);
+
+    EXPECT_EQ(pruned.destination.r, 4);
+    EXPECT_EQ(pruned.destination.c, 3);
+    EXPECT_EQ(unpruned.destination.r, pruned.destination.r);
+    EXPECT_EQ(unpruned.destination.c, pruned.destination.c);
+}
+
+TEST_F(SearchTest, ShallowPruningKeepsMateInOne) {
+    search.params.futilityMargin[1] = 0;
+    search.params.futilityMargin[2] = 0;
+    search.params.razorMargin[1] = 0;
+    search.params.razorMargin[2] = 0;
+
+    Board board("6k1/5ppp/8/8/8/8/8/4Q2K w - - 0 1");
+    Move best = search.findBestMove(board, 2);
+
+    board.makeMove(best, false);
+    auto moves = getLegalMoves(board);
+    EXPECT_TRUE(moves.empty());
+    EXPECT_TRUE(board.isChecked(Color::Black));
+}
+
+TEST_F(SearchTest, CheckExtensionFindsBackRankMate) {
+    // Rd8+ Re8 Rxe8# lies past a one-ply horizon; the checking line has to be followed
+    Board board("6k1/4rppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    Move best = search.findBestMove(board, 1);
+    EXPECT_EQ(best.destination.r, 0);
+    EXPECT_EQ(best.destination.c, 3);
+}
+
+TEST_F(SearchTest, SingularExtensionKeepsMateInTwo) {
+    // Lowered threshold so singular searches actually run at these depths
+    search.params.singularDepth = 2;
+    Board board("7k/8/4KP2/5PQP/6P1/8/8/8 w - - 0 1");
+    Move best = search.findBestMove(board, 4);
+    board.makeMove(best, false);
+    Move reply = search.findBestMove(board, 3);
+    board.makeMove(reply, false);
+    Move mate = search.findBestMove(board, 2);
+    board.makeMove(mate, false);
+
+    EXPECT_TRUE(getLegalMoves(board).empty());
+    EXPECT_TRUE(board.isChecked(Color::Black));
+}
+
+TEST_F(SearchTest, GenerateCapturesIncludesQuietQueenPromotion) {
+    Board board("4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    auto captures = Generator::generateCaptures(board);
+    ASSERT_EQ(captures.size(), 1u);
+    EXPECT_EQ(captures[0].type, MoveType::Promotion);
+    EXPECT_EQ(captures[0].promotion, PieceKind::Queen);
+    EXPECT_EQ(captures[0].destination.r, 0);
+}
+
+TEST_F(SearchTest, QuiescenceAvoidsLosingCapture) {
+    // Qxd5 wins a pawn but drops the queen to c6xd5; the capture has to be pruned, not played
+    Board board("4k3/8/2p5/3p4/8/8/3Q4/4K3 w - - 0 1");
+    search.setInfoOutput(false);
+    Move best = search.findBestMove(board, 2);
+    EXPECT_FALSE(best.destination.r == 3 && best.destination.c == 3);
+
+    uint64_t seePrunes = 0;
+    for (const DepthStats& d : search.getStats().depths) seePrunes += d.seePrunes;
+    EXPECT_GT(seePrunes, 0u);
+}
+
+TEST_F(SearchTest, FailLowEntriesCarryNoMove) {
+    Board board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    search.setInfoOutput(false);
+    search.findBestMove(board, 4);
+
+    // Flags are white-relative: a side failed low when it is White's upper bound or Black's lower bound
+    int failLows = 0;
+    auto check = [&](const Board& position) {
+        const TTEntry* entry = search.probeTT(position.getHash());
+        if (!entry) return;
+        const uint8_t failLow = position.getColor() == Color::White ? UPPER_BOUND : LOWER_BOUND;
+        if (entry->flag != failLow) return;
+        failLows++;
+        EXPECT_EQ(entry->bestMove, Move{}) << position.toFEN();
+    };
+    for (const Move& move : getLegalMoves(board)) {
+        MoveUndo undo = board.makeMove(move, false);
+        check(board);
+        for (const Move& reply : getLegalMoves(board)) {
+            MoveUndo replyUndo = board.makeMove(reply, false);
+            check(board);
+            board.undoMove(replyUndo);
+        }
+        board.undoMove(undo);
+    }
+    EXPECT_GT(failLows, 0);
+}
+
+TEST_F(SearchTest, InfoLineReportsNodesAndPv) {
+    Board board;
+    testing::internal::CaptureStdout();
+    Move best = search.findBestMove(board, 3);
+    const std::string out = testing::internal::GetCapturedStdout();
+
+    EXPECT_GT(search.getNodes(), 0u);
+    const auto line = out.rfind("info depth 3 ");
+    ASSERT_NE(line, std::string::npos);
+    for (const char* field : {" seldepth ", " score cp ", " nodes ", " nps ", " hashfull ", " time ", " pv "}) {
+        EXPECT_NE(out.find(field, line), std::string::npos) << field;
+    }
+    // The reported line starts with the move we play
+    EXPECT_NE(out.find(" pv " + Board::toUCI(best), line), std::string::npos);
+}
+
+TEST_F(SearchTest, InfoLineReportsMateDistance) {
+    Board board("6k1/5ppp/8/8/8/8/8/4Q2K w - - 0 1");
+    testing::internal::CaptureStdout();
+    search.findBestMove(board, 2);
+    const std::string out = testing::internal::GetCapturedStdout();
+    EXPECT_NE(out.find("score mate 1 "), std::string::npos);
+}
+
+TEST_F(SearchTest, MultiPVReportsDistinctLines) {
+    Board board;
+    search.setMultiPV(3);
+    testing::internal::CaptureStdout();
+    Move best = search.findBestMove(board, 3);
+    const std::string out = testing::internal::GetCapturedStdout();
+
+    const auto depth3 = out.find("info depth 3 ");
+    ASSERT_NE(depth3, std::string::npos);
+    std::vector<std::string> firstMoves;
+    for (int i = 1; i <= 3; i++) {
+        const auto line = out.find("multipv " + std::to_string(i) + " ", depth3);
+        ASSERT_NE(line, std::string::npos);
+        const auto pv = out.find(" pv ", line) + 4;
+        firstMoves.push_back(out.substr(pv, 4));
+    }
+
+    EXPECT_EQ(firstMoves[0], Board::toUCI(best));
+    EXPECT_NE(firstMoves[0], firstMoves[1]);
+    EXPECT_NE(firstMoves[0], firstMoves[2]);
+    EXPECT_NE(firstMoves[1], firstMoves[2]);
+}
+
+TEST_F(SearchTest, MultiPVCappedByLegalMoves) {
+    // Only Kg8 and Kh7 escape the check; asking for more lines must not invent any
+    Board board("7k/8/5Q2/8/8/8/8/K7 b - - 0 1");
+    search.setMultiPV(5);
+    testing::internal::CaptureStdout();
+    search.findBestMove(board, 2);
+    const std::string out = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(out.find("multipv 3 "), std::string::npos);
+    EXPECT_NE(out.find("multipv 2 "), std::string::npos);
+}
+
+TEST_F(SearchTest, MoveTimeIsRespected) {
+    Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    SearchLimits limits;
+    limits.movetime = 200;
+    testing::internal::CaptureStdout();
+    const auto start = std::chrono::steady_clock::now();
+    const Move best = search.findBestMove(board, limits);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    testing::internal::GetCapturedStdout();
+    EXPECT_TRUE(board.parseUCI(Board::toUCI(best)).has_value());
+    EXPECT_LT(ms, 400);
+}
+
+TEST_F(SearchTest, ClockLimitStillFindsMate) {
+    // A short clock must leave enough time to complete the shallow iterations that see the mate
+    Board board("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    SearchLimits limits;
+    limits.wtime = 1000;
+    limits.btime = 1000;
+    testing::internal::CaptureStdout();
+    const auto start = std::chrono::steady_clock::now();
+    const Move best = search.findBestMove(board, limits);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    testing::internal::GetCapturedStdout();
+    EXPECT_EQ(Board::toUCI(best), "a1a8");
+    EXPECT_LT(ms, 500);
+}
+
+TEST_F(SearchTest, NodeLimitIsReproducible) {
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    SearchLimits limits;
+    limits.nodes = 20000;
+
+    testing::internal::CaptureStdout();
+    search.clearTT();
+    const Move first = search.findBestMove(board, limits);
+    const uint64_t firstNodes = search.getNodes();
+    search.clearTT();
+    const Move second = search.findBestMove(board, limits);
+    testing::internal::GetCapturedStdout();
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(firstNodes, search.getNodes());
+    EXPECT_EQ(firstNodes, limits.nodes);
+}
+
+TEST_F(SearchTest, AbortedIterationLeavesTheCompletedOne) {
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    search.setInfoOutput(false);
+    search.clearTT();
+    const Move completed = search.findBestMove(board, 4);
+    const std::vector<RootMove> expected = search.getRootMoves();
+    const uint64_t depth4Nodes = search.getNodes();
+    search.clearTT();
+    search.findBestMove(board, 5);
+    const uint64_t depth5Nodes = search.getNodes();
+
+    // Stopped late in depth 5, after the same four iterations and once several root moves have new results
+    SearchLimits limits;
+    limits.nodes = depth4Nodes + (depth5Nodes - depth4Nodes) * 9 / 10;
+    search.clearTT();
+    EXPECT_EQ(search.findBestMove(board, limits), completed);
+
+    const std::vector<RootMove>& rootMoves = search.getRootMoves();
+    ASSERT_EQ(rootMoves.size(), expected.size());
+    for (size_t i = 0; i < rootMoves.size(); i++) {
+        EXPECT_EQ(rootMoves[i].move, expected[i].move) << i;
+        EXPECT_EQ(rootMoves[i].score, expected[i].score) << i;
+        EXPECT_EQ(rootMoves[i].pv, expected[i].pv) << i;
+    }
+}
+
+TEST_F(SearchTest, StatsRecordEachCompletedDepth) {
+    Board board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    testing::internal::CaptureStdout();
+    search.findBestMove(board, 4);
+    testing::internal::GetCapturedStdout();
+
+    const SearchStats& stats = search.getStats();
+    ASSERT_EQ(stats.depths.size(), 4u);
+    uint64_t total = 0;
+    for (const DepthStats& d : stats.depths) {
+        EXPECT_LE(d.firstMoveCutoffs, d.betaCutoffs);
+        EXPECT_LE(d.betaCutoffs, d.moveLoops);
+        total += d.nodes + d.qnodes;
+    }
+    EXPECT_GT(stats.depths[3].nodes, stats.depths[0].nodes);
+    // Everything but the root nodes is attributed to an iteration
+    EXPECT_LE(total, search.getNodes());
+    EXPECT_GE(total + 4, search.getNodes());
+
+    std::ostringstream out;
+    stats.print(out);
+    EXPECT_NE(out.str().find("stats depth=4 nodes="), std::string::npos);
+}
+
+TEST_F(SearchTest, SearchTreeDoesNotAllocate) {
+    if (!AllocTracker::ENABLED) GTEST_SKIP() << "needs -DCHESS_ALLOC_TRACKING=ON";
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10");
+    testing::internal::CaptureStdout();
+    search.findBestMove(board, 5);
+    testing::internal::GetCapturedStdout();
+
+    const AllocStats& allocs = search.getStats().allocs;
+    EXPECT_EQ(allocs.tree.allocations, 0u);
+    EXPECT_GT(allocs.setup.allocations, 0u);
+}
+
+TEST_F(SearchTest, LazyEvaluationStopsOutsideWindow) {
+    Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10");
+    PawnTable pawns;
+    MaterialTable material;
+    const int full = Search::evaluate(board);
+
+    bool exact = false;
+    EXPECT_EQ(Search::evaluate(board, &pawns, &material, full - 10, full + 10, exact), full);
+    EXPECT_TRUE(exact);
+
+    const int lazy = Search::evaluate(board, &pawns, &material, full + 1000, full + 1001, exact);
+    EXPECT_FALSE(exact);
+    EXPECT_LE(std::abs(lazy - full), Search::LAZY_MARGIN);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <bit>
+#include <random>
+#include <vector>
+#include "board/board.h"
+#include "eval/simd.h"
+#include "search/search.h"
+#include "search/zobrist.h"
+
+class SimdTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Zobrist::init();
+    }
+    void TearDown() override {
+        Simd::setLevel(Simd::detect());
+    }
+
+    static std::vector<Simd::Level> supportedLevels() {
+        std::vector<Simd::Level> levels;
+        for (const Simd::Level level : {Simd::Level::Scalar, Simd::Level::Sse42, Simd::Level::Avx2}) {
+            if (level <= Simd::detect()) levels.push_back(level);
+        }
+        return levels;
+    }
+};
+
+TEST_F(SimdTest, KernelsMatchScalarReference) {
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<int> weight(-9, 9);
+    // Every length up to a full board of pieces, so each vector kernel also runs its scalar tail
+    for (int n = 0; n <= 32; n++) {
+        std::vector<uint64_t> bits(n);
+        std::vector<int16_t> weights(n);
+        int expected = 0;
+        for (int i = 0; i < n; i++) {
+            bits[i] = i % 5 == 0 ? ~uint64_t{0} : rng() & rng();
+            weights[i] = static_cast<int16_t>(weight(rng));
+            expected += std::popcount(bits[i]) * weights[i];
+        }
+        for (const Simd::Level level : supportedLevels()) {
+            EXPECT_EQ(Simd::weightedPopcount(level, bits.data(), weights.data(), n), expected)
+                << Simd::name(level) << " n=" << n;
+        }
+    }
+}
+
+TEST_F(SimdTest, SetLevelFallsBackToSupported) {
+    EXPECT_EQ(Simd::setLevel(Simd::Level::Scalar), Simd::Level::Scalar);
+    EXPECT_EQ(Simd::level(), Simd::Level::Scalar);
+    EXPECT_EQ(Simd::setLevel(Simd::Level::Avx2), Simd::detect());
+}
+
+TEST_F(SimdTest, EvaluationIndependentOfLevel) {
+    for (const char* fen : {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+            "r1b2rk1/pppp1ppp/8/4p1NQ/8/8/PPPP1PPP/R1B1K2R w KQ - 0 1"}) {
+        Board board(fen);
+        Simd::setLevel(Simd::Level::Scalar);
+        const int scalar = Search::evaluate(board);
+        for (const Simd::Level level : supportedLevels()) {
+            Simd::setLevel(level);
+            EXPECT_EQ(Search::evaluate(board), scalar) << Simd::name(level) << " " << fen;
+        }
+    }
+}
@@ -5,6 +5,8 @@
 #include "generator/generator.h"
 #include "search/zobrist.h"
 
+#include <chrono>
+
 class TranspositionTableTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -72,6 +74,16 @@ TEST_F(TranspositionTableTest, ShallowerSearchDoesNotReplace) {
     EXPECT_TRUE(sameMove(entry->bestMove, bestMove));
 }
 
+TEST_F(TranspositionTableTest, ExcludedMoveSearchUsesSeparateKey) {
+    TranspositionTable tt(16);
+
+    Board board;
+    tt.store(board.getHash(), 100, 5, EXACT, bestMove);
+
+    EXPECT_EQ(tt.probe(board.getHash() ^ Zobrist::exclusion), nullptr);
+    EXPECT_NE(tt.probe(board.getHash()), nullptr);
+}
+
 // Search with TT tests
 class SearchWithTTTest : public ::testing::Test {
 protected:
@@ -113,6 +125,8 @@ TEST_F(SearchWithTTTest, SamePositionSameResult) {
 
 TEST_F(SearchWithTTTest, TTSpeedsUpSearch) {
     Board board("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    // IIR deliberately searches hash-move-less nodes shallower, so a cold TT would do less work here
+    search.params.iirDepth = INF;
 
     // First search - cold TT
     auto start1 = std::chrono::high_resolution_clock::now();
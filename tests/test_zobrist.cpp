@@ -120,4 +120,33 @@ TEST_F(ZobristTest, CastlingRightsAffectHash) {
     Board board2("r1bqk2r/pppppppp/8/8/8/8/PPPPPPPP/R1BQK2R w Kq - 0 1");
 
     EXPECT_NE(board1.getHash(), board2.getHash());
-}
\ No newline at end of file
+}
+TEST_F(ZobristTest, PawnHashTracksPawnMovesAndCaptures) {
+    // Pawn push, pawn takes pawn, en passant, a piece taking a pawn and a promotion, each checked against a
+    // freshly computed key and restored by undo
+    Board board("r3k2r/1P3ppp/8/3pP3/8/8/P4PPP/R3K1NR w KQkq d6 0 1");
+    const uint64_t originalPawnHash = board.getPawnHash();
+
+    std::vector<MoveUndo> undos;
+    for (const char* uci : {"e5d6", "a8a2", "g1f3", "f7f6", "b7b8q"}) {
+        const uint64_t before = board.getPawnHash();
+        undos.push_back(board.makeMove(board.parseUCI(uci).value(), false));
+        Board fresh(board.toFEN());
+        EXPECT_EQ(board.getPawnHash(), fresh.getPawnHash()) << uci;
+        if (std::string(uci) == "g1f3") EXPECT_EQ(board.getPawnHash(), before);
+        else EXPECT_NE(board.getPawnHash(), before) << uci;
+    }
+
+    for (auto it = undos.rbegin(); it != undos.rend(); ++it) board.undoMove(*it);
+    EXPECT_EQ(board.getPawnHash(), originalPawnHash);
+}
+
+TEST_F(ZobristTest, PawnHashIgnoresPiecesAndSideToMove) {
+    Board board1("4k3/pp6/8/8/8/8/PP6/4K3 w - - 0 1");
+    Board board2("r3k3/pp6/8/8/8/5N2/PP6/4K3 b - - 0 1");
+    EXPECT_EQ(board1.getPawnHash(), board2.getPawnHash());
+    EXPECT_NE(board1.getHash(), board2.getHash());
+
+    Board pawnless("4k3/8/8/8/8/8/8/4K2R w - - 0 1");
+    EXPECT_EQ(pawnless.getPawnHash(), 0u);
+}